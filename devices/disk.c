@@ -84,7 +84,7 @@ static void reset_channel (struct channel *);
 static bool check_device_type (struct disk *);
 static void identify_ata_device (struct disk *);
 
-static void select_sector (struct disk *, disk_sector_t);
+static void select_sector (struct disk *, disk_sector_t, size_t sec_cnt);
 static void issue_pio_command (struct channel *, uint8_t command);
 static void input_sector (struct channel *, void *);
 static void output_sector (struct channel *, const void *);
@@ -210,44 +210,80 @@ disk_size (struct disk *d) {
    per-disk locking is unneeded. */
 void
 disk_read (struct disk *d, disk_sector_t sec_no, void *buffer) {
+	disk_read_multiple (d, sec_no, buffer, 1);
+}
+
+/* Write sector SEC_NO to disk D from BUFFER, which must contain
+   DISK_SECTOR_SIZE bytes.  Returns after the disk has
+   acknowledged receiving the data.
+   Internally synchronizes accesses to disks, so external
+   per-disk locking is unneeded. */
+void
+disk_write (struct disk *d, disk_sector_t sec_no, const void *buffer) {
+	disk_write_multiple (d, sec_no, buffer, 1);
+}
+
+/* Reads SEC_CNT consecutive sectors starting at SEC_NO from disk D
+   into BUFFER, which must have room for SEC_CNT * DISK_SECTOR_SIZE
+   bytes.  The whole run is transferred by one multi-sector command
+   under a single acquisition of the channel lock.  SEC_CNT must be
+   between 1 and DISK_MAX_SECTORS. */
+void
+disk_read_multiple (struct disk *d, disk_sector_t sec_no, void *buffer,
+		size_t sec_cnt) {
 	struct channel *c;
+	uint8_t *p = buffer;
+	size_t i;
 
 	ASSERT (d != NULL);
 	ASSERT (buffer != NULL);
+	ASSERT (sec_cnt >= 1 && sec_cnt <= DISK_MAX_SECTORS);
 
 	c = d->channel;
 	lock_acquire (&c->lock);
-	select_sector (d, sec_no);
+	select_sector (d, sec_no, sec_cnt);
 	issue_pio_command (c, CMD_READ_SECTOR_RETRY);
-	sema_down (&c->completion_wait);
-	if (!wait_while_busy (d))
-		PANIC ("%s: disk read failed, sector=%"PRDSNu, d->name, sec_no);
-	input_sector (c, buffer);
-	d->read_cnt++;
+	for (i = 0; i < sec_cnt; i++) {
+		/* The disk interrupts once per sector that is ready. */
+		sema_down (&c->completion_wait);
+		if (!wait_while_busy (d))
+			PANIC ("%s: disk read failed, sector=%"PRDSNu, d->name,
+					(disk_sector_t) (sec_no + i));
+		input_sector (c, p + i * DISK_SECTOR_SIZE);
+	}
+	d->read_cnt += sec_cnt;
 	lock_release (&c->lock);
 }
 
-/* Write sector SEC_NO to disk D from BUFFER, which must contain
-   DISK_SECTOR_SIZE bytes.  Returns after the disk has
-   acknowledged receiving the data.
-   Internally synchronizes accesses to disks, so external
-   per-disk locking is unneeded. */
+/* Writes SEC_CNT consecutive sectors starting at SEC_NO to disk D
+   from BUFFER, which must contain SEC_CNT * DISK_SECTOR_SIZE bytes.
+   Returns after the disk has acknowledged the last sector.  SEC_CNT
+   must be between 1 and DISK_MAX_SECTORS. */
 void
-disk_write (struct disk *d, disk_sector_t sec_no, const void *buffer) {
+disk_write_multiple (struct disk *d, disk_sector_t sec_no, const void *buffer,
+		size_t sec_cnt) {
 	struct channel *c;
+	const uint8_t *p = buffer;
+	size_t i;
 
 	ASSERT (d != NULL);
 	ASSERT (buffer != NULL);
+	ASSERT (sec_cnt >= 1 && sec_cnt <= DISK_MAX_SECTORS);
 
 	c = d->channel;
 	lock_acquire (&c->lock);
-	select_sector (d, sec_no);
+	select_sector (d, sec_no, sec_cnt);
 	issue_pio_command (c, CMD_WRITE_SECTOR_RETRY);
-	if (!wait_while_busy (d))
-		PANIC ("%s: disk write failed, sector=%"PRDSNu, d->name, sec_no);
-	output_sector (c, buffer);
-	sema_down (&c->completion_wait);
-	d->write_cnt++;
+	for (i = 0; i < sec_cnt; i++) {
+		/* The disk asks for each sector with DRQ and interrupts once it
+		   has taken it. */
+		if (!wait_while_busy (d))
+			PANIC ("%s: disk write failed, sector=%"PRDSNu, d->name,
+					(disk_sector_t) (sec_no + i));
+		output_sector (c, p + i * DISK_SECTOR_SIZE);
+		sema_down (&c->completion_wait);
+	}
+	d->write_cnt += sec_cnt;
 	lock_release (&c->lock);
 }
 
@@ -403,17 +439,18 @@ print_ata_string (char *string, size_t size) {
 }
 
 /* Selects device D, waiting for it to become ready, and then
-   writes SEC_NO to the disk's sector selection registers.  (We
-   use LBA mode.) */
+   writes SEC_NO and SEC_CNT to the disk's sector selection
+   registers.  (We use LBA mode.) */
 static void
-select_sector (struct disk *d, disk_sector_t sec_no) {
+select_sector (struct disk *d, disk_sector_t sec_no, size_t sec_cnt) {
 	struct channel *c = d->channel;
 
-	ASSERT (sec_no < d->capacity);
-	ASSERT (sec_no < (1UL << 28));
+	ASSERT (sec_no + sec_cnt <= d->capacity);
+	ASSERT (sec_no + sec_cnt <= (1UL << 28));
 
 	select_device_wait (d);
-	outb (reg_nsect (c), 1);
+	/* A sector count of 0 means 256 sectors. */
+	outb (reg_nsect (c), sec_cnt == DISK_MAX_SECTORS ? 0 : sec_cnt);
 	outb (reg_lbal (c), sec_no);
 	outb (reg_lbam (c), sec_no >> 8);
 	outb (reg_lbah (c), (sec_no >> 16));
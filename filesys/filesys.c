@@ -8,6 +8,9 @@
 #include "filesys/directory.h"
 #include "devices/disk.h"
 #include "filesys/fat.h"
+#ifdef EFILESYS
+#include "filesys/page_cache.h"
+#endif
 
 /* The disk that contains the file system. */
 struct disk *filesys_disk;
@@ -48,6 +51,7 @@ void
 filesys_done (void) {
 	/* Original FS */
 #ifdef EFILESYS
+	page_cache_flush ();
 	fat_close ();
 #else
 	free_map_close ();
@@ -7,6 +7,10 @@
 #include "filesys/free-map.h"
 #include "threads/malloc.h"
 #include "filesys/fat.h"
+#ifdef EFILESYS
+#include "filesys/page_cache.h"
+#include "threads/vaddr.h"
+#endif
 
 /* Identifies an inode. */
 #define INODE_MAGIC 0x494e4f44
@@ -205,6 +209,10 @@ inode_close (struct inode *inode) {
 	if (--inode->open_cnt == 0) {
 		/* Remove from inode list and release lock. */
 		list_remove (&inode->elem);
+#ifdef EFILESYS
+		/* 지워질 파일이면 캐시된 내용을 내려쓸 필요 없음 */
+		page_cache_release (inode, !inode->removed);
+#endif
 		disk_write (filesys_disk, inode->sector, &inode->data);
 		/* Deallocate blocks if removed. */
 		if (inode->removed) {
@@ -239,6 +247,11 @@ inode_read_at (struct inode *inode, void *buffer_, off_t size, off_t offset) {
 	off_t bytes_read = 0;
 	uint8_t *bounce = NULL;
 
+#ifdef EFILESYS
+	if (page_cache_enabled ())
+		return page_cache_read (inode, buffer_, size, offset);
+#endif
+
 	while (size > 0) {
 		/* Disk sector to read, starting byte offset within sector. */
 		disk_sector_t sector_idx = byte_to_sector (inode, offset);
@@ -331,6 +344,9 @@ inode_write_at (struct inode *inode, const void *buffer_, off_t size,
 	if (offset + size > inode_length(inode)) {
 		file_growth(inode, offset+size);
 	}
+
+	if (page_cache_enabled ())
+		return page_cache_write (inode, buffer_, size, offset);
 #endif
 
 	while (size > 0) {
@@ -380,6 +396,54 @@ inode_write_at (struct inode *inode, const void *buffer_, off_t size,
 	return bytes_written;
 }
 
+/*** haein ***/
+/* Writes SIZE bytes from BUFFER into INODE at OFFSET like
+ * inode_write_at(), for the writeback of an evicted mmap page. It never
+ * takes a user frame for the page cache, so the writeback thread cannot
+ * end up waiting for itself. */
+off_t
+inode_write_back (struct inode *inode, const void *buffer, off_t size,
+		off_t offset) {
+	if (inode->deny_write_cnt)
+		return 0;
+
+#ifdef EFILESYS
+	if (page_cache_enabled ())
+		return page_cache_write_back (inode, buffer, size, offset);
+#endif
+	return inode_write_at (inode, buffer, size, offset);
+}
+
+#ifdef EFILESYS
+/*** haein ***/
+/* Reads the PGSIZE bytes of INODE at page-aligned OFS straight from the
+ * disk into KVA, zero-filling whatever lies past the end of the file.
+ * Used by the page cache to fill a page. */
+void
+inode_read_page (struct inode *inode, off_t ofs, void *kva) {
+	uint8_t *buffer = kva;
+
+	for (off_t pos = 0; pos < PGSIZE; pos += DISK_SECTOR_SIZE) {
+		if (ofs + pos < inode_length (inode))
+			disk_read (filesys_disk, byte_to_sector (inode, ofs + pos), buffer + pos);
+		else
+			memset (buffer + pos, 0, DISK_SECTOR_SIZE);
+	}
+}
+
+/*** haein ***/
+/* Writes the page of INODE at page-aligned OFS from KVA straight to the
+ * disk, skipping sectors past the end of the file. */
+void
+inode_write_page (struct inode *inode, off_t ofs, const void *kva) {
+	const uint8_t *buffer = kva;
+
+	for (off_t pos = 0; pos < PGSIZE && ofs + pos < inode_length (inode);
+			pos += DISK_SECTOR_SIZE)
+		disk_write (filesys_disk, byte_to_sector (inode, ofs + pos), buffer + pos);
+}
+#endif
+
 /* Disables writes to INODE.
    May be called at most once per inode opener. */
 	void
@@ -1,9 +1,18 @@
 /* page_cache.c: Implementation of Page Cache (Buffer Cache). */
 
 #include "vm/vm.h"
+#ifdef EFILESYS
+#include <string.h>
+#include "filesys/inode.h"
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+#include "devices/timer.h"
+
 static bool page_cache_readahead (struct page *page, void *kva);
 static bool page_cache_writeback (struct page *page);
 static void page_cache_destroy (struct page *page);
+static void page_cache_kworkerd (void *aux);
 
 /* DO NOT MODIFY this struct */
 static const struct page_operations page_cache_op = {
@@ -15,36 +24,392 @@ static const struct page_operations page_cache_op = {
 
 tid_t page_cache_workerd;
 
+#define WRITEBACK_INTERVAL TIMER_FREQ	/* kworkerd가 dirty page를 내려쓰는 주기 (tick) */
+
+/* (inode, ofs) -> struct page. page는 spt에 들어가지 않으므로 hash_elem을 그대로 씀.
+ * lock 순서: page_cache_lock -> frame_lock. frame을 새로 얻으면 writeback을
+ * 기다릴 수 있고 writeback thread는 mmap page를 쓰면서 page_cache_lock을 잡으므로,
+ * page_cache_lock을 든 채로는 frame을 얻지 않음. frame_lock을 잡은 evict 경로는
+ * page cache page를 디스크에 바로 쓰고 page_cache_lock은 잡지 않음 */
+static struct hash page_cache_table;
+static struct lock page_cache_lock;
+static struct condition page_cache_idle;	/* 어떤 page의 users가 0이 됨 */
+static bool page_cache_ready;			/* vm_init 전에는 inode가 디스크를 직접 읽음 */
+static uint8_t *write_back_bounce;		/* page_cache_write_back용, page_cache_lock이 보호 */
+
+static uint64_t page_cache_hash (const struct hash_elem *e, void *aux);
+static bool page_cache_less (const struct hash_elem *a, const struct hash_elem *b, void *aux);
+static struct page *page_cache_lookup (struct inode *inode, off_t ofs);
+static struct page *page_cache_get (struct inode *inode, off_t ofs, bool *miss);
+static void page_cache_put (struct page *page);
+
+/*** haein ***/
 /* The initializer of file vm */
 void
 pagecache_init (void) {
 	/* TODO: Create a worker daemon for page cache with page_cache_kworkerd */
+	hash_init (&page_cache_table, page_cache_hash, page_cache_less, NULL);
+	lock_init (&page_cache_lock);
+	cond_init (&page_cache_idle);
+	write_back_bounce = palloc_get_page (PAL_ASSERT);
+	page_cache_ready = true;
+	page_cache_workerd = thread_create ("kworkerd", PRI_DEFAULT, page_cache_kworkerd, NULL);
 }
 
+/*** haein ***/
 /* Initialize the page cache */
 bool
-page_cache_initializer (struct page *page, enum vm_type type, void *kva) {
+page_cache_initializer (struct page *page, enum vm_type type UNUSED, void *kva UNUSED) {
 	/* Set up the handler */
 	page->operations = &page_cache_op;
 
+	struct page_cache *page_cache = &page->page_cache;
+	page_cache->inode = NULL;
+	page_cache->ofs = 0;
+	page_cache->dirty = false;
+	page_cache->users = 0;
+	return true;
 }
 
+/*** haein ***/
+/* Returns true once file data can go through the page cache. */
+bool
+page_cache_enabled (void) {
+	return page_cache_ready;
+}
+
+/*** haein ***/
 /* Utilze the Swap in mechanism to implement readhead */
 static bool
 page_cache_readahead (struct page *page, void *kva) {
+	struct page_cache *page_cache = &page->page_cache;
+
+	inode_read_page (page_cache->inode, page_cache->ofs, kva);
+	return true;
 }
 
+/*** haein ***/
 /* Utilze the Swap out mechanism to implement writeback */
 static bool
 page_cache_writeback (struct page *page) {
+	struct page_cache *page_cache = &page->page_cache;
+
+	if (page_cache->dirty) {
+		page_cache->dirty = false;
+		inode_write_page (page_cache->inode, page_cache->ofs, page->frame->kva);
+	}
+	return true;
 }
 
+/*** haein ***/
 /* Destory the page_cache. */
 static void
 page_cache_destroy (struct page *page) {
+	vm_free_frame (page);
 }
 
+/*** haein ***/
 /* Worker thread for page cache */
 static void
-page_cache_kworkerd (void *aux) {
+page_cache_kworkerd (void *aux UNUSED) {
+	for (;;) {
+		timer_sleep (WRITEBACK_INTERVAL);
+		page_cache_flush ();
+	}
+}
+
+/*** haein ***/
+/* Reads SIZE bytes of INODE starting at OFFSET into BUFFER through the
+ * page cache. Returns the number of bytes read. A miss also pulls the
+ * following page of the file into the cache. */
+off_t
+page_cache_read (struct inode *inode, void *buffer_, off_t size, off_t offset) {
+	uint8_t *buffer = buffer_;
+	off_t bytes_read = 0;
+
+	while (size > 0) {
+		off_t page_ofs = offset - offset % PGSIZE;
+		int ofs_in_page = offset % PGSIZE;
+
+		/* Bytes left in inode, bytes left in page, lesser of the two. */
+		off_t inode_left = inode_length (inode) - offset;
+		int page_left = PGSIZE - ofs_in_page;
+		int min_left = inode_left < page_left ? inode_left : page_left;
+
+		int chunk_size = size < min_left ? size : min_left;
+		if (chunk_size <= 0)
+			break;
+
+		bool miss;
+		lock_acquire (&page_cache_lock);
+		struct page *page = page_cache_get (inode, page_ofs, &miss);
+		lock_release (&page_cache_lock);
+		if (page == NULL)
+			break;
+
+		/* pin이 걸려 있으므로 lock 없이 복사해도 evict되지 않고, users가
+		 * 남아 있으므로 page_cache_release가 지우지 않음.
+		 * BUFFER에서 page fault가 나도 page_cache_lock을 다시 잡을 수 있음 */
+		memcpy (buffer + bytes_read, (uint8_t *) page->frame->kva + ofs_in_page, chunk_size);
+		page_cache_put (page);
+
+		/* 다음 page를 미리 읽어 둠 */
+		if (miss && page_ofs + PGSIZE < inode_length (inode)) {
+			lock_acquire (&page_cache_lock);
+			struct page *next = page_cache_get (inode, page_ofs + PGSIZE, &miss);
+			lock_release (&page_cache_lock);
+			if (next != NULL)
+				page_cache_put (next);
+		}
+
+		/* Advance. */
+		size -= chunk_size;
+		offset += chunk_size;
+		bytes_read += chunk_size;
+	}
+	return bytes_read;
+}
+
+/*** haein ***/
+/* Writes SIZE bytes from BUFFER into INODE starting at OFFSET through
+ * the page cache. The inode must already be long enough. Returns the
+ * number of bytes written; they reach the disk on eviction or on the
+ * next kworkerd pass. */
+off_t
+page_cache_write (struct inode *inode, const void *buffer_, off_t size, off_t offset) {
+	const uint8_t *buffer = buffer_;
+	off_t bytes_written = 0;
+
+	while (size > 0) {
+		off_t page_ofs = offset - offset % PGSIZE;
+		int ofs_in_page = offset % PGSIZE;
+
+		/* Bytes left in inode, bytes left in page, lesser of the two. */
+		off_t inode_left = inode_length (inode) - offset;
+		int page_left = PGSIZE - ofs_in_page;
+		int min_left = inode_left < page_left ? inode_left : page_left;
+
+		int chunk_size = size < min_left ? size : min_left;
+		if (chunk_size <= 0)
+			break;
+
+		bool miss;
+		lock_acquire (&page_cache_lock);
+		struct page *page = page_cache_get (inode, page_ofs, &miss);
+		lock_release (&page_cache_lock);
+		if (page == NULL)
+			break;
+
+		memcpy ((uint8_t *) page->frame->kva + ofs_in_page, buffer + bytes_written, chunk_size);
+		/* 복사가 끝난 뒤에 표시해야 kworkerd가 덜 쓴 내용만 내려쓰고 끝나지 않음 */
+		page->page_cache.dirty = true;
+		page_cache_put (page);
+
+		/* Advance. */
+		size -= chunk_size;
+		offset += chunk_size;
+		bytes_written += chunk_size;
+	}
+	return bytes_written;
+}
+
+/*** haein ***/
+/* Writes SIZE bytes from BUFFER into INODE starting at OFFSET for the
+ * writeback of an evicted mmap page. Unlike page_cache_write() it never
+ * takes a frame: a cached page is updated in place, any other page is
+ * patched on disk through a bounce page. The disk write happens under
+ * page_cache_lock, so a concurrent miss cannot cache the old contents. */
+off_t
+page_cache_write_back (struct inode *inode, const void *buffer_, off_t size, off_t offset) {
+	const uint8_t *buffer = buffer_;
+	off_t bytes_written = 0;
+
+	while (size > 0) {
+		off_t page_ofs = offset - offset % PGSIZE;
+		int ofs_in_page = offset % PGSIZE;
+
+		/* Bytes left in inode, bytes left in page, lesser of the two. */
+		off_t inode_left = inode_length (inode) - offset;
+		int page_left = PGSIZE - ofs_in_page;
+		int min_left = inode_left < page_left ? inode_left : page_left;
+
+		int chunk_size = size < min_left ? size : min_left;
+		if (chunk_size <= 0)
+			break;
+
+		lock_acquire (&page_cache_lock);
+		struct page *page = page_cache_lookup (inode, page_ofs);
+		if (page != NULL && vm_pin_page (page)) {
+			memcpy ((uint8_t *) page->frame->kva + ofs_in_page, buffer + bytes_written, chunk_size);
+			page->page_cache.dirty = true;
+			vm_unpin_page (page);
+		} else {
+			if (chunk_size < PGSIZE)
+				inode_read_page (inode, page_ofs, write_back_bounce);
+			memcpy (write_back_bounce + ofs_in_page, buffer + bytes_written, chunk_size);
+			inode_write_page (inode, page_ofs, write_back_bounce);
+		}
+		lock_release (&page_cache_lock);
+
+		/* Advance. */
+		size -= chunk_size;
+		offset += chunk_size;
+		bytes_written += chunk_size;
+	}
+	return bytes_written;
+}
+
+/*** haein ***/
+/* Drops every cached page of INODE, writing dirty ones back first if
+ * WRITE_BACK. Called when the last opener closes INODE. */
+void
+page_cache_release (struct inode *inode, bool write_back) {
+	if (!page_cache_ready)
+		return;
+
+	lock_acquire (&page_cache_lock);
+	for (off_t ofs = 0; ofs < inode_length (inode) + PGSIZE; ofs += PGSIZE) {
+		struct page *page;
+
+		/* 아직 복사 중인 reader/writer가 있으면 끝날 때까지 기다림.
+		 * 기다리는 동안 page가 바뀌었을 수 있으므로 다시 찾음 */
+		while ((page = page_cache_lookup (inode, ofs)) != NULL && page->page_cache.users > 0)
+			cond_wait (&page_cache_idle, &page_cache_lock);
+		if (page == NULL)
+			continue;
+
+		hash_delete (&page_cache_table, &page->hash_elem);
+		if (write_back && page->page_cache.dirty && vm_pin_page (page)) {
+			swap_out (page);
+			vm_unpin_page (page);
+		}
+		vm_dealloc_page (page);
+	}
+	lock_release (&page_cache_lock);
+}
+
+/*** haein ***/
+/* Writes every dirty cached page back to disk. */
+void
+page_cache_flush (void) {
+	struct hash_iterator i;
+
+	if (!page_cache_ready)
+		return;
+
+	lock_acquire (&page_cache_lock);
+	hash_first (&i, &page_cache_table);
+	while (hash_next (&i)) {
+		struct page *page = hash_entry (hash_cur (&i), struct page, hash_elem);
+
+		/* evict된 page는 이미 writeback이 끝났으므로 dirty가 아님 */
+		if (page->page_cache.dirty && vm_pin_page (page)) {
+			swap_out (page);
+			vm_unpin_page (page);
+		}
+	}
+	lock_release (&page_cache_lock);
+}
+
+/*** haein ***/
+/* Returns the page caching OFS of INODE, or NULL. Must hold page_cache_lock. */
+static struct page *
+page_cache_lookup (struct inode *inode, off_t ofs) {
+	struct page key;
+	struct hash_elem *e;
+
+	key.page_cache.inode = inode;
+	key.page_cache.ofs = ofs;
+	e = hash_find (&page_cache_table, &key.hash_elem);
+	return e != NULL ? hash_entry (e, struct page, hash_elem) : NULL;
+}
+
+/*** haein ***/
+/* Returns the page caching OFS of INODE with its frame loaded and pinned,
+ * creating it if needed. *MISS tells whether the disk had to be read.
+ * Returns NULL if memory runs out. Must hold page_cache_lock, which is
+ * dropped while a frame is taken for a miss. Release the page with
+ * page_cache_put(). */
+static struct page *
+page_cache_get (struct inode *inode, off_t ofs, bool *miss) {
+	struct frame *frame = NULL;
+	struct page *page;
+
+	*miss = false;
+	for (;;) {
+		page = page_cache_lookup (inode, ofs);
+		if (page == NULL) {
+			page = slab_alloc (&page_slab);
+			if (page == NULL)
+				break;
+
+			page->va = NULL;
+			page->frame = NULL;
+			page->writable = true;
+			page_cache_initializer (page, VM_PAGE_CACHE, NULL);
+			page->page_cache.inode = inode;
+			page->page_cache.ofs = ofs;
+			hash_insert (&page_cache_table, &page->hash_elem);
+		}
+		if (vm_pin_page (page))
+			break;
+
+		/* lock을 잡고 있으므로 같은 page를 두 번 읽어 오지 않음 */
+		if (frame != NULL) {
+			*miss = true;
+			if (!vm_pin_page_in (page, frame))
+				page = NULL;
+			frame = NULL;
+			break;
+		}
+
+		/* frame을 얻다가 writeback을 기다릴 수 있으므로 lock을 놓고 얻음.
+		 * 그 사이에 page가 올라오거나 지워졌을 수 있어 처음부터 다시 찾음 */
+		lock_release (&page_cache_lock);
+		frame = vm_reserve_frame ();
+		lock_acquire (&page_cache_lock);
+		if (frame == NULL) {
+			page = NULL;
+			break;
+		}
+	}
+
+	if (frame != NULL)
+		vm_unreserve_frame (frame);
+	if (page != NULL)
+		page->page_cache.users++;
+	return page;
+}
+
+/*** haein ***/
+/* Releases a page returned by page_cache_get(): unpins its frame and
+ * wakes page_cache_release() if it waits for the page. */
+static void
+page_cache_put (struct page *page) {
+	lock_acquire (&page_cache_lock);
+	vm_unpin_page (page);
+	if (--page->page_cache.users == 0)
+		cond_broadcast (&page_cache_idle, &page_cache_lock);
+	lock_release (&page_cache_lock);
+}
+
+/*** haein ***/
+static uint64_t
+page_cache_hash (const struct hash_elem *e, void *aux UNUSED) {
+	const struct page *page = hash_entry (e, struct page, hash_elem);
+
+	return hash_bytes (&page->page_cache.inode, sizeof page->page_cache.inode)
+		^ hash_int (page->page_cache.ofs);
+}
+
+/*** haein ***/
+static bool
+page_cache_less (const struct hash_elem *a_, const struct hash_elem *b_, void *aux UNUSED) {
+	const struct page_cache *a = &hash_entry (a_, struct page, hash_elem)->page_cache;
+	const struct page_cache *b = &hash_entry (b_, struct page, hash_elem)->page_cache;
+
+	if (a->inode != b->inode)
+		return a->inode < b->inode;
+	return a->ofs < b->ofs;
 }
+#endif /* EFILESYS */
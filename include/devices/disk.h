@@ -2,6 +2,7 @@
 #define DEVICES_DISK_H
 
 #include <inttypes.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /* Size of a disk sector in bytes. */
@@ -11,6 +12,10 @@
  * Good enough for disks up to 2 TB. */
 typedef uint32_t disk_sector_t;
 
+/* Most sectors a single disk_read_multiple() or
+ * disk_write_multiple() may transfer. */
+#define DISK_MAX_SECTORS 256
+
 /* Format specifier for printf(), e.g.:
  * printf ("sector=%"PRDSNu"\n", sector); */
 #define PRDSNu PRIu32
@@ -22,6 +27,9 @@ struct disk *disk_get (int chan_no, int dev_no);
 disk_sector_t disk_size (struct disk *);
 void disk_read (struct disk *, disk_sector_t, void *);
 void disk_write (struct disk *, disk_sector_t, const void *);
+void disk_read_multiple (struct disk *, disk_sector_t, void *, size_t sec_cnt);
+void disk_write_multiple (struct disk *, disk_sector_t, const void *,
+		size_t sec_cnt);
 
 void 	register_disk_inspect_intr ();
 #endif /* devices/disk.h */
@@ -16,8 +16,13 @@ void inode_close (struct inode *);
 void inode_remove (struct inode *);
 off_t inode_read_at (struct inode *, void *, off_t size, off_t offset);
 off_t inode_write_at (struct inode *, const void *, off_t size, off_t offset);
+off_t inode_write_back (struct inode *, const void *, off_t size, off_t offset);
 void inode_deny_write (struct inode *);
 void inode_allow_write (struct inode *);
 off_t inode_length (const struct inode *);
+#ifdef EFILESYS
+void inode_read_page (struct inode *, off_t ofs, void *kva);
+void inode_write_page (struct inode *, off_t ofs, const void *kva);
+#endif
 
 #endif /* filesys/inode.h */
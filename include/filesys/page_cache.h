@@ -1,12 +1,31 @@
 #ifndef FILESYS_PAGE_CACHE_H
 #define FILESYS_PAGE_CACHE_H
-#include "vm/vm.h"
+#include <stdbool.h>
+#include "filesys/off_t.h"
 
 struct page;
+struct inode;
 enum vm_type;
 
-struct page_cache {};
+/*** haein ***/
+/* 파일의 PGSIZE 단위 한 조각을 담는 page. 어떤 주소 공간에도 매핑되지 않고
+ * (inode, ofs)로 page cache table에서 찾음 */
+struct page_cache {
+	struct inode *inode;	/* 캐시하는 파일 */
+	off_t ofs;				/* 파일 내 offset, PGSIZE 단위 */
+	bool dirty;				/* 디스크에 아직 쓰지 않은 내용이 있는지 */
+	int users;				/* page_cache_get으로 얻어 lock 없이 복사 중인 thread 수 */
+};
+
+/* vm.h의 struct page가 위의 struct page_cache를 품으므로 정의 뒤에 include */
+#include "vm/vm.h"
 
-void page_cache_init (void);
+void pagecache_init (void);
 bool page_cache_initializer (struct page *page, enum vm_type type, void *kva);
+bool page_cache_enabled (void);
+off_t page_cache_read (struct inode *inode, void *buffer, off_t size, off_t offset);
+off_t page_cache_write (struct inode *inode, const void *buffer, off_t size, off_t offset);
+off_t page_cache_write_back (struct inode *inode, const void *buffer, off_t size, off_t offset);
+void page_cache_release (struct inode *inode, bool write_back);
+void page_cache_flush (void);
 #endif
@@ -36,6 +36,13 @@ enum {
 
 	SYS_MOUNT,
 	SYS_UMOUNT,
+
+	/* Extra for Project 3 */
+	SYS_MADVISE,                /* Advise the kernel on a memory access pattern. */
+	SYS_MSYNC,                  /* Write a memory mapping back to its file. */
+	SYS_SET_RSS_LIMIT,          /* Limit the process's resident pages. */
+	SYS_GET_RSS,                /* Count the process's resident pages. */
+	SYS_SBRK,                   /* Move the end of the process's heap. */
 };
 
 #endif /* lib/syscall-nr.h */
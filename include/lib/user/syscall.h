@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <debug.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /* Process identifier. */
 typedef int pid_t;
@@ -13,6 +14,13 @@ typedef int pid_t;
 typedef int off_t;
 #define MAP_FAILED ((void *) NULL)
 
+/* Access patterns for madvise(). */
+#define MADV_NORMAL 0           /* No special treatment. */
+#define MADV_RANDOM 1           /* Expect random page references. */
+#define MADV_SEQUENTIAL 2       /* Expect sequential page references. */
+#define MADV_WILLNEED 3         /* Will need these pages soon. */
+#define MADV_DONTNEED 4         /* Drop these pages now. */
+
 /* Maximum characters in a filename written by readdir(). */
 #define READDIR_MAX_LEN 14
 
@@ -41,6 +49,11 @@ int dup2(int oldfd, int newfd);
 /* Project 3 and optionally project 4. */
 void *mmap (void *addr, size_t length, int writable, int fd, off_t offset);
 void munmap (void *addr);
+int madvise (void *addr, size_t length, int advice);
+int msync (void *addr, size_t length);
+void set_rss_limit (size_t pages);
+size_t get_rss (void);
+void *sbrk (intptr_t increment);
 
 /* Project 4 only. */
 bool chdir (const char *dir);
@@ -0,0 +1,27 @@
+#ifndef THREADS_SLAB_H
+#define THREADS_SLAB_H
+
+#include <list.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "threads/synch.h"
+
+/* An object cache: hands out fixed-size objects of one type from
+   pages that hold nothing else. */
+struct slab_cache {
+	const char *name;           /* For debugging. */
+	size_t obj_size;            /* Size of each object in bytes. */
+	size_t objs_per_slab;       /* Number of objects in a slab. */
+	void (*ctor) (void *);      /* Run on each object handed out, or null. */
+	struct list partial;        /* Slabs with at least one free object. */
+	size_t slab_cnt;            /* Slabs owned by this cache. */
+	bool has_empty;             /* One fully free slab is kept around. */
+	struct lock lock;           /* Lock. */
+};
+
+void slab_cache_init (struct slab_cache *, const char *name, size_t obj_size,
+		void (*ctor) (void *));
+void *slab_alloc (struct slab_cache *);
+void slab_free (struct slab_cache *, void *);
+
+#endif /* threads/slab.h */
@@ -119,6 +119,9 @@ struct thread
 	/* Table for whole virtual memory owned by thread. */
 	struct supplemental_page_table spt;
 	uint64_t rsp;    /* 유저영역에서 발생한 인터럽트일 때 인터럽트 프레임(유저영역)의 rsp값을 저장해둠 */ /*** haein-side ***/
+	struct list frames;	/* 이 프로세스 몫으로 잡힌 frame들 (frame->owner_elem), frame_lock으로 보호 */
+	size_t rss;			/* frames의 길이 = resident set size (page) */
+	size_t rss_limit;	/* rss 상한, 0이면 제한 없음. fork/exec을 거쳐도 유지됨 */
 #endif
 	/* Owned by thread.c. */
 	struct intr_frame tf; /* Information for switching */
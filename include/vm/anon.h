@@ -2,14 +2,23 @@
 #define VM_ANON_H
 #include "vm/vm.h"
 struct page;
+struct frame;
 enum vm_type;
 
 struct anon_page {
     int slot_number;
     enum vm_type aux_type;      /*** GrilledSalmon ***/
+    int zswap_chunk;            /* zswap arena 위치, ZSWAP_NONE / ZSWAP_ZERO */
+    uint16_t zswap_len;         /* 압축된 길이 */
 };
 
+extern bool swap_scratch_busy;
+
 void vm_anon_init (void);
+bool swap_set_disks (const char *spec);
 bool anon_initializer (struct page *page, enum vm_type type, void *kva);
+bool anon_swap_out_cluster (struct page *pages[], size_t cnt);
+void anon_swap_out_shared (struct frame *frame);
+void *do_mmap_anon (void *addr, size_t length, int writable);
 
 #endif
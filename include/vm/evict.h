@@ -0,0 +1,27 @@
+#ifndef VM_EVICT_H
+#define VM_EVICT_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct frame;
+
+/* Page replacement policy. 모든 함수는 frame_lock을 잡은 상태에서 불림 */
+struct evict_policy {
+	const char *name;						/* -evict= 에 쓰는 이름 */
+	void (*init) (void);
+	void (*insert) (struct frame *);		/* frame에 page가 막 채워져 evict 대상이 됨 */
+	void (*remove) (struct frame *);		/* frame이 user pool로 돌아가거나 evict됨 */
+	struct frame *(*select) (void);			/* victim 선택, 없으면 NULL */
+};
+
+bool evict_policy_set (const char *name);
+void evict_init (struct frame *table, size_t size);
+void evict_insert (struct frame *frame);
+void evict_remove (struct frame *frame);
+struct frame *evict_select (void);
+void evict_note_fault (bool refault);
+void evict_forget (uint64_t *pml4);
+void evict_print_stats (void);
+
+#endif
@@ -11,7 +11,7 @@ struct file_page {
 	struct file *file;
 	off_t ofs;
 	size_t read_bytes;
-	int *remain_cnt;
+	struct vm_region *region;	/* lazy_info와 같은 배치 */
 };
 
 void vm_file_init (void);
@@ -19,4 +19,6 @@ bool file_backed_initializer (struct page *page, enum vm_type type, void *kva);
 void *do_mmap(void *addr, size_t length, int writable,
 		struct file *file, off_t offset);
 void do_munmap (void *va);
+bool do_msync (void *addr, size_t length);
+void file_region_writeback (struct vm_region *region, void *start, void *end);
 #endif
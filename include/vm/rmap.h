@@ -0,0 +1,29 @@
+#ifndef VM_RMAP_H
+#define VM_RMAP_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct frame;
+struct page;
+
+/* Reverse map: frame마다 그 frame을 매핑한 (pml4, va)의 list.
+ * 모든 함수는 frame_lock을 잡은 상태에서 불림. writeback 중인 frame은
+ * 매핑이 바뀌지 않으므로 writeback thread는 lock 없이 읽기만 할 수 있음 */
+
+typedef void rmap_action_func (struct page *page, void *aux);
+
+void rmap_init (void);
+void rmap_add (struct frame *frame, uint64_t *pml4, struct page *page);
+void rmap_remove (struct frame *frame, uint64_t *pml4, void *va);
+size_t rmap_count (struct frame *frame);
+struct page *rmap_single (struct frame *frame, uint64_t **pml4);
+bool rmap_is_accessed (struct frame *frame);
+bool rmap_test_and_clear_accessed (struct frame *frame);
+bool rmap_is_dirty (struct frame *frame);
+struct page *rmap_first (struct frame *frame);
+void rmap_apply (struct frame *frame, rmap_action_func *action, void *aux);
+void rmap_unmap_all (struct frame *frame);
+void rmap_detach_all (struct frame *frame);
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef VM_VM_H
 #define VM_VM_H
 #include <stdbool.h>
+#include <stdint.h>
 #include "threads/palloc.h"
 #include "lib/kernel/hash.h"
+#include "lib/kernel/list.h"
+#include "threads/slab.h"
 
 enum vm_type {
 	/* page not initialized */
@@ -36,10 +39,22 @@ enum vm_type {
 
 struct page_operations;
 struct thread;
+struct vm_region;
+struct shared_text;
 
 #define VM_TYPE(type) ((type) & 7)
 #define VM_AUXTYPE(type) ((type) & 24)		/*** GrilledSalmon ***/
 
+/*** haein ***/
+/* madvise()로 알려 주는 접근 패턴. lib/user/syscall.h의 MADV_*와 같은 값 */
+enum vm_advice {
+	VM_ADV_NORMAL = 0,		/* 기본 fault-around */
+	VM_ADV_RANDOM = 1,		/* fault-around 하지 않음 */
+	VM_ADV_SEQUENTIAL = 2,	/* window를 늘리고 지나간 page는 먼저 evict */
+	VM_ADV_WILLNEED = 3,	/* 지금 미리 읽어 둠 */
+	VM_ADV_DONTNEED = 4,	/* frame과 swap slot을 바로 버림 */
+};
+
 /* The representation of "page".
  * This is kind of "parent class", which has four "child class"es, which are
  * uninit_page, file_page, anon_page, and page cache (project4).
@@ -73,12 +88,23 @@ struct page {
 };
 
 /* The representation of "frame" */
-/* 물리 메모리 나타냄 */
+/* 물리 메모리 나타냄, user pool의 frame마다 frame_table에 하나씩 고정으로 존재 */
 struct frame {
 	void *kva; 			// kernel virtual address
 	struct page *page;	// a page structure
-	struct list_elem frame_elem;	// for frame_table
-	uint64_t *pml4;
+	uint64_t *pml4;		// NULL for kernel-owned pages (page cache)
+	struct list mappings;	// 이 frame을 매핑한 (pml4, va)들 (vm/rmap.c)
+	int share_cnt;		// number of pages mapping this frame (copy-on-write)
+	int pin_cnt;		// pinned frames are never chosen as victims
+	struct shared_text *text;	// read-only ELF page shared by (inode, ofs), or NULL
+	bool accessed;		// accessed bit for frames without a pml4
+	struct list_elem lru_elem;	// 교체 정책(vm/evict.c)의 list
+	struct thread *owner;		// rss에 이 frame을 세는 프로세스, 주인이 없으면 NULL
+	struct list_elem owner_elem;	// owner->frames
+	bool writeback;		// writeback thread가 내보내는 중 (그동안 pin 되어 있음)
+	struct list_elem wb_elem;	// writeback_queue
+	uint8_t lru_list;	// lru_elem이 들어 있는 list, 없으면 0
+	bool lru_new;		// list에 들어온 뒤 아직 검사받지 않음
 };
 
 /*** GrilledSalmon ***/
@@ -88,7 +114,23 @@ struct lazy_info {
 	struct file *file;
 	off_t ofs;
 	size_t read_bytes;
-	int *remain_cnt;
+	struct vm_region *region;	/* page가 속한 region */
+};
+
+/*** haein ***/
+/* mmap이나 ELF segment처럼 연속된 page들을 한 번에 기술하는 구조체.
+ * struct page는 그 page에 처음 접근할 때 만들어짐 */
+struct vm_region {
+	void *start;			/* 첫 page */
+	void *end;				/* 마지막 page 다음 주소 */
+	enum vm_type type;		/* VM_FILE (mmap), VM_SEG or VM_ANON (익명 mmap, heap) */
+	bool writable;
+	vm_initializer *init;	/* page 내용을 채울 함수 */
+	struct file *file;		/* mmap이면 region이 소유, segment는 NULL (running 사용) */
+	off_t ofs;				/* START에 대응하는 파일 offset */
+	size_t file_bytes;		/* START부터 파일에서 읽을 바이트 수, 나머지는 0 */
+	enum vm_advice advice;	/* madvise로 받은 접근 패턴 */
+	struct list_elem elem;	/* supplemental_page_table.regions, START 순 */
 };
 
 /* The function table for page operations.
@@ -113,8 +155,18 @@ struct page_operations {
 /* Representation of current process's memory space.
  * We don't want to force you to obey any specific design for this struct.
  * All designs up to you for this. */
+#define SPT_CACHE_SIZE 16		/* page_lookup cache의 slot 수 (2의 거듭제곱) */
+#define SPT_CACHE_SLOT(va) (pg_no (va) & (SPT_CACHE_SIZE - 1))
+
 struct supplemental_page_table {
 	struct hash h;
+	struct page *cache[SPT_CACHE_SIZE];	/* 최근 page_lookup 결과, page 번호로 direct-mapped */
+	struct list regions;	/* struct vm_region, sorted by start */
+	struct vm_region *region_hint;	/* 마지막으로 vm_region_find가 찾은 region */
+	struct thread *owner;	/* Thread whose address space this table describes */
+	void *heap_start;		/* 마지막 segment 다음 page, heap은 여기서 시작 */
+	void *brk;				/* 현재 program break */
+	struct vm_region *heap;	/* [heap_start, brk)를 덮는 region, heap이 비었으면 NULL */
 };
 
 #include "threads/thread.h"
@@ -125,7 +177,26 @@ void supplemental_page_table_kill (struct supplemental_page_table *spt);
 struct page *spt_find_page (struct supplemental_page_table *spt,
 		void *va);
 bool spt_insert_page (struct supplemental_page_table *spt, struct page *page);
+struct page *page_lookup (struct supplemental_page_table *spt, const void *va);
 void spt_remove_page (struct supplemental_page_table *spt, struct page *page);
+struct vm_region *vm_region_add (struct supplemental_page_table *spt,
+		void *start, size_t length, enum vm_type type, bool writable,
+		vm_initializer *init, struct file *file, off_t ofs, size_t file_bytes);
+struct vm_region *vm_region_find (struct supplemental_page_table *spt,
+		const void *va);
+void vm_region_remove (struct supplemental_page_table *spt,
+		struct vm_region *region);
+bool vm_madvise (void *addr, size_t length, enum vm_advice advice);
+void vm_set_rss_limit (size_t limit);
+void *vm_sbrk (intptr_t increment);
+void vm_mapped_read (struct inode *inode, off_t ofs, void *buf, size_t size);
+void vm_mapped_write (struct inode *inode, off_t ofs, const void *buf, size_t size);
+
+extern struct slab_cache page_slab;
+extern struct slab_cache lazy_info_slab;
+extern size_t reclaim_low_wm;
+extern size_t reclaim_high_wm;
+extern size_t rss_default_limit;
 
 void vm_init (void);
 bool vm_try_handle_fault (struct intr_frame *f, void *addr, bool user,
@@ -136,6 +207,13 @@ bool vm_try_handle_fault (struct intr_frame *f, void *addr, bool user,
 bool vm_alloc_page_with_initializer (enum vm_type type, void *upage,
 		bool writable, vm_initializer *init, void *aux);
 void vm_dealloc_page (struct page *page);
+void vm_free_frame (struct page *page);
+void vm_wait_writeback (struct page *page);
+bool vm_pin_page (struct page *page);
+struct frame *vm_reserve_frame (void);
+void vm_unreserve_frame (struct frame *frame);
+bool vm_pin_page_in (struct page *page, struct frame *frame);
+void vm_unpin_page (struct page *page);
 bool vm_claim_page (void *va);
 enum vm_type page_get_type (struct page *page);
 
@@ -0,0 +1,15 @@
+#ifndef VM_ZSWAP_H
+#define VM_ZSWAP_H
+#include <stdbool.h>
+
+struct anon_page;
+
+#define ZSWAP_NONE (-1)		/* zswap에 없음 */
+#define ZSWAP_ZERO (-2)		/* 전부 0인 page, arena를 쓰지 않음 */
+
+void zswap_init (void);
+bool zswap_store (struct anon_page *anon_page, const void *kva);
+void zswap_load (struct anon_page *anon_page, void *kva);
+void zswap_free (struct anon_page *anon_page);
+
+#endif
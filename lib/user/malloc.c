@@ -0,0 +1,176 @@
+#include <malloc.h>
+#include <round.h>
+#include <stdint.h>
+#include <string.h>
+#include <syscall.h>
+
+/* A simple user-level allocator on top of sbrk().
+
+   Every block starts with a header that records its size,
+   header included.  Free blocks are kept on a singly linked
+   list sorted by address, so that free() can merge a block
+   with the free blocks right before and after it.  malloc()
+   takes the first free block that is large enough and splits
+   off the rest if it is big enough to be useful on its own.
+
+   When no free block fits, the heap is grown by at least
+   HEAP_GROW bytes at a time and the new space is freed into
+   the list, where it merges with a free block at the old end
+   of the heap.  Memory is never given back to the kernel. */
+
+/* Header of a block.  NEXT is only meaningful for free blocks. */
+struct block {
+	size_t size;                /* Size in bytes, header included. */
+	struct block *next;         /* Next free block, in address order. */
+};
+
+#define ALIGN 16                                  /* Alignment of blocks. */
+#define HDR_SIZE ROUND_UP (sizeof (struct block), ALIGN)
+#define MIN_BLOCK (HDR_SIZE + ALIGN)              /* Smallest block to split off. */
+#define HEAP_GROW (16 * 4096)                     /* Minimum sbrk() increment. */
+
+static struct block *free_list;
+
+static bool heap_grow (size_t size);
+static void insert_free (struct block *);
+
+/* Obtains and returns a new block of at least SIZE bytes.
+   Returns a null pointer if memory is not available. */
+void *
+malloc (size_t size) {
+	struct block **bp, *b;
+	size_t need;
+
+	if (size == 0 || size > SIZE_MAX / 2)
+		return NULL;
+	need = HDR_SIZE + ROUND_UP (size, ALIGN);
+
+	for (;;) {
+		for (bp = &free_list; *bp != NULL; bp = &(*bp)->next) {
+			b = *bp;
+			if (b->size < need)
+				continue;
+
+			if (b->size - need >= MIN_BLOCK) {
+				struct block *rest = (struct block *) ((uint8_t *) b + need);
+				rest->size = b->size - need;
+				rest->next = b->next;
+				*bp = rest;
+				b->size = need;
+			} else
+				*bp = b->next;
+			return (uint8_t *) b + HDR_SIZE;
+		}
+
+		if (!heap_grow (need))
+			return NULL;
+	}
+}
+
+/* Allocates and return A times B bytes initialized to zeroes.
+   Returns a null pointer if memory is not available. */
+void *
+calloc (size_t a, size_t b) {
+	void *p;
+	size_t size;
+
+	size = a * b;
+	if (b != 0 && size / b != a)
+		return NULL;
+
+	p = malloc (size);
+	if (p != NULL)
+		memset (p, 0, size);
+	return p;
+}
+
+/* Attempts to resize OLD_BLOCK to NEW_SIZE bytes, possibly
+   moving it in the process.  If successful, returns the new
+   block; on failure, returns a null pointer.  A call with null
+   OLD_BLOCK is equivalent to malloc(NEW_SIZE).  A call with zero
+   NEW_SIZE is equivalent to free(OLD_BLOCK). */
+void *
+realloc (void *old_block, size_t new_size) {
+	if (new_size == 0) {
+		free (old_block);
+		return NULL;
+	} else if (old_block == NULL)
+		return malloc (new_size);
+	else {
+		struct block *b = (struct block *) ((uint8_t *) old_block - HDR_SIZE);
+		size_t old_size = b->size - HDR_SIZE;
+		void *new_block;
+
+		/* 이미 충분히 크면 그대로 씀. */
+		if (new_size <= old_size)
+			return old_block;
+
+		new_block = malloc (new_size);
+		if (new_block != NULL) {
+			memcpy (new_block, old_block, old_size);
+			free (old_block);
+		}
+		return new_block;
+	}
+}
+
+/* Frees block P, which must have been previously allocated with
+   malloc(), calloc(), or realloc(). */
+void
+free (void *p) {
+	if (p != NULL)
+		insert_free ((struct block *) ((uint8_t *) p - HDR_SIZE));
+}
+
+/* Extends the heap by enough to hold a block of SIZE bytes and
+   adds the new space to the free list.  Returns false if the
+   kernel refuses to grow the heap. */
+static bool
+heap_grow (size_t size) {
+	static bool aligned;
+	size_t grow = ROUND_UP (size > HEAP_GROW ? size : HEAP_GROW, ALIGN);
+	uint8_t *p;
+
+	/* 처음에는 break를 ALIGN 경계로 맞춰 둠. */
+	if (!aligned) {
+		uintptr_t brk = (uintptr_t) sbrk (0);
+		if (brk % ALIGN != 0 && sbrk (ALIGN - brk % ALIGN) == (void *) -1)
+			return false;
+		aligned = true;
+	}
+
+	p = sbrk (grow);
+	if (p == (void *) -1)
+		return false;
+
+	struct block *b = (struct block *) p;
+	b->size = grow;
+	insert_free (b);
+	return true;
+}
+
+/* Inserts B into the free list at its address, merging it with
+   the free blocks that directly precede and follow it. */
+static void
+insert_free (struct block *b) {
+	struct block *prev = NULL, *next = free_list;
+
+	while (next != NULL && next < b) {
+		prev = next;
+		next = next->next;
+	}
+
+	if (next != NULL && (uint8_t *) b + b->size == (uint8_t *) next) {
+		b->size += next->size;
+		b->next = next->next;
+	} else
+		b->next = next;
+
+	if (prev != NULL && (uint8_t *) prev + prev->size == (uint8_t *) b) {
+		prev->size += b->size;
+		prev->next = b->next;
+	} else if (prev != NULL)
+		prev->next = b;
+	else
+		free_list = b;
+}
@@ -156,6 +156,31 @@ munmap (void *addr) {
 	syscall1 (SYS_MUNMAP, addr);
 }
 
+int
+madvise (void *addr, size_t length, int advice) {
+	return syscall3 (SYS_MADVISE, addr, length, advice);
+}
+
+int
+msync (void *addr, size_t length) {
+	return syscall2 (SYS_MSYNC, addr, length);
+}
+
+void
+set_rss_limit (size_t pages) {
+	syscall1 (SYS_SET_RSS_LIMIT, pages);
+}
+
+size_t
+get_rss (void) {
+	return syscall0 (SYS_GET_RSS);
+}
+
+void *
+sbrk (intptr_t increment) {
+	return (void *) syscall1 (SYS_SBRK, increment);
+}
+
 bool
 chdir (const char *dir) {
 	return syscall1 (SYS_CHDIR, dir);
@@ -0,0 +1,79 @@
+/* Writes a file through the page cache and reads it back, waits for
+   kworkerd to flush it, then pushes the cached pages out of memory
+   with a large buffer.  read() must return what was written, both for
+   pages that were flushed before eviction and for pages that were
+   still dirty, and after the file is closed and opened again. */
+
+#include <random.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define FILE_SIZE (16 * PAGE_SIZE)
+#define PRESSURE_SIZE (12 * 1024 * 1024)
+
+static const char file_name[] = "data";
+static char buf[FILE_SIZE];
+static char rbuf[FILE_SIZE];
+static char pressure[PRESSURE_SIZE];
+
+/* Touches every page of PRESSURE, which is larger than memory, so
+   that the file's cached pages get evicted. */
+static void
+evict_cache (int round)
+{
+  size_t i;
+
+  msg ("evict cached pages");
+  for (i = 0; i < PRESSURE_SIZE / PAGE_SIZE; i++)
+    pressure[i * PAGE_SIZE] = round;
+}
+
+static void
+read_back (int fd, const char *what)
+{
+  seek (fd, 0);
+  CHECK (read (fd, rbuf, FILE_SIZE) == FILE_SIZE, "read \"%s\"", file_name);
+  if (memcmp (rbuf, buf, FILE_SIZE))
+    fail ("%s: data read back differs from data written", what);
+}
+
+void
+test_main (void)
+{
+  long long read_cnt, write_cnt;
+  size_t i;
+  int fd;
+
+  CHECK (create (file_name, FILE_SIZE), "create \"%s\"", file_name);
+  CHECK ((fd = open (file_name)) > 1, "open \"%s\"", file_name);
+  random_bytes (buf, sizeof buf);
+  CHECK (write (fd, buf, FILE_SIZE) == FILE_SIZE, "write \"%s\"", file_name);
+  read_back (fd, "cached data");
+
+  /* kworkerd는 WRITEBACK_INTERVAL마다 dirty page를 내려씀 */
+  msg ("wait for kworkerd to flush \"%s\"", file_name);
+  write_cnt = get_fs_disk_write_cnt ();
+  while (get_fs_disk_write_cnt () < write_cnt + FILE_SIZE / 512)
+    continue;
+
+  evict_cache (1);
+  read_cnt = get_fs_disk_read_cnt ();
+  read_back (fd, "flushed data");
+  CHECK (get_fs_disk_read_cnt () > read_cnt, "evicted pages were read from disk");
+
+  for (i = 0; i < FILE_SIZE; i++)
+    buf[i] ^= 0x5a;
+  seek (fd, 0);
+  CHECK (write (fd, buf, FILE_SIZE) == FILE_SIZE, "overwrite \"%s\"", file_name);
+  evict_cache (2);
+  read_back (fd, "data dirty at eviction");
+
+  msg ("close \"%s\"", file_name);
+  close (fd);
+  CHECK ((fd = open (file_name)) > 1, "reopen \"%s\"", file_name);
+  read_back (fd, "data after reopen");
+  close (fd);
+}
@@ -0,0 +1,23 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(bc-evict) begin
+(bc-evict) create "data"
+(bc-evict) open "data"
+(bc-evict) write "data"
+(bc-evict) read "data"
+(bc-evict) wait for kworkerd to flush "data"
+(bc-evict) evict cached pages
+(bc-evict) read "data"
+(bc-evict) evicted pages were read from disk
+(bc-evict) overwrite "data"
+(bc-evict) evict cached pages
+(bc-evict) read "data"
+(bc-evict) close "data"
+(bc-evict) reopen "data"
+(bc-evict) read "data"
+(bc-evict) end
+EOF
+pass;
@@ -0,0 +1,46 @@
+/* Checks that anonymous memory (an fd -1 mapping and the sbrk() heap)
+   is shared copy-on-write across fork: the child starts out on the
+   parent's frames and gets copies of its own only once it writes. */
+
+#include <string.h>
+#include <syscall.h>
+#include <stdint.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define ANON ((char *) 0x10000000)
+
+void
+test_main (void)
+{
+	pid_t child;
+	char *heap;
+	void *pa_anon, *pa_heap;
+
+	CHECK (mmap (ANON, PAGE_SIZE, 1, -1, 0) == ANON, "mmap anonymous page");
+	CHECK ((heap = sbrk (PAGE_SIZE)) != (void *) -1, "grow heap by 1 page");
+	memset (ANON, 'a', PAGE_SIZE);
+	memset (heap, 'h', PAGE_SIZE);
+	pa_anon = get_phys_addr (ANON);
+	pa_heap = get_phys_addr (heap);
+
+	child = fork ("child");
+	if (child == 0) {
+		CHECK (get_phys_addr (ANON) == pa_anon && get_phys_addr (heap) == pa_heap,
+				"two phys addrs should be the same.");
+		CHECK (ANON[0] == 'a' && heap[0] == 'h', "check data consistency");
+
+		ANON[0] = '@';
+		heap[0] = '@';
+		CHECK (get_phys_addr (ANON) != pa_anon && get_phys_addr (heap) != pa_heap,
+				"two phys addrs should not be the same.");
+		CHECK (ANON[0] == '@' && ANON[1] == 'a' && heap[0] == '@' && heap[1] == 'h',
+				"check data change");
+		return;
+	}
+	wait (child);
+	CHECK (get_phys_addr (ANON) == pa_anon && get_phys_addr (heap) == pa_heap,
+			"two phys addrs should be the same.");
+	CHECK (ANON[0] == 'a' && heap[0] == 'h', "check data consistency");
+}
@@ -0,0 +1,25 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+our ($test);
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(evict-clock) begin
+(evict-clock) write round 0
+(evict-clock) check round 0
+(evict-clock) write round 1
+(evict-clock) check round 1
+(evict-clock) end
+EOF
+
+# The workload only passes if it really ran under this policy and
+# pages were evicted and faulted back in.
+my ($stats) = grep (/^Evict: /, read_text_file ("$test.output"));
+fail "missing \"Evict:\" statistics line\n" if !defined $stats;
+my ($policy, $refaults, $evictions) = $stats =~
+  /^Evict: (\S+) policy, \d+ page-ins, (\d+) refaults, (\d+) evictions/
+  or fail "malformed statistics line: $stats\n";
+fail "ran under the $policy policy, not clock\n" if $policy ne 'clock';
+fail "no page was evicted\n" if $evictions == 0;
+fail "no evicted page was faulted back in\n" if $refaults == 0;
+pass;
@@ -0,0 +1,57 @@
+/* Workload shared by the evict-* tests, each of which runs it under
+   a different -evict= policy.  A buffer four times larger than the
+   user pool is written twice, while a small hot set is read back
+   between every few pages.  Every page must keep its data no matter
+   which pages the policy picks as victims. */
+
+#include <string.h>
+#include <stdint.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define ONE_MB (1 << 20)
+#define CHUNK_SIZE (16 * ONE_MB)
+#define PAGE_COUNT (CHUNK_SIZE / PAGE_SIZE)
+#define HOT_PAGES 32
+#define HOT_STRIDE 64
+#define ROUNDS 2
+
+static char chunk[CHUNK_SIZE];
+
+static size_t
+page_value (size_t page, int round)
+{
+	return page * 7 + round;
+}
+
+static void
+check_page (size_t page, int round)
+{
+	if (*(size_t *) (chunk + page * PAGE_SIZE) != page_value (page, round))
+		fail ("page %zu has bad data in round %d", page, round);
+}
+
+void
+test_main (void)
+{
+	size_t i, j;
+	int round;
+
+	for (round = 0; round < ROUNDS; round++) {
+		msg ("write round %d", round);
+		for (i = 0; i < PAGE_COUNT; i++) {
+			*(size_t *) (chunk + i * PAGE_SIZE) = page_value (i, round);
+
+			/* 앞쪽 HOT_PAGES page는 자주 다시 읽음 */
+			if (i >= HOT_PAGES && i % HOT_STRIDE == 0)
+				for (j = 0; j < HOT_PAGES; j++)
+					check_page (j, round);
+		}
+
+		msg ("check round %d", round);
+		for (i = 0; i < PAGE_COUNT; i++)
+			check_page (i, round);
+	}
+}
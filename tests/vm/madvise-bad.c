@@ -0,0 +1,35 @@
+/* Passes bad arguments to madvise(), which must fail without killing
+   the process, then gives access pattern hints for a real mapping. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define ACTUAL ((char *) 0x10000000)
+
+void
+test_main (void)
+{
+	CHECK (mmap (ACTUAL, 2 * PAGE_SIZE, 1, -1, 0) == ACTUAL,
+			"mmap 2 anonymous pages");
+
+	CHECK (madvise (ACTUAL + 1, PAGE_SIZE, MADV_NORMAL) == -1,
+			"madvise misaligned address (must fail)");
+	CHECK (madvise (ACTUAL, 0, MADV_NORMAL) == -1,
+			"madvise zero length (must fail)");
+	CHECK (madvise (ACTUAL, PAGE_SIZE, MADV_DONTNEED + 1) == -1,
+			"madvise bad advice (must fail)");
+	CHECK (madvise ((void *) 0x20000000, PAGE_SIZE, MADV_WILLNEED) == -1,
+			"madvise unmapped range (must fail)");
+	CHECK (madvise ((void *) 0x8004000000, PAGE_SIZE, MADV_NORMAL) == -1,
+			"madvise kernel address (must fail)");
+
+	CHECK (madvise (ACTUAL, 2 * PAGE_SIZE, MADV_SEQUENTIAL) == 0,
+			"madvise MADV_SEQUENTIAL");
+	CHECK (madvise (ACTUAL, 2 * PAGE_SIZE, MADV_RANDOM) == 0,
+			"madvise MADV_RANDOM");
+	CHECK (madvise (ACTUAL, 0x20000000, MADV_NORMAL) == 0,
+			"madvise range larger than the mapping");
+	munmap (ACTUAL);
+}
@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(madvise-bad) begin
+(madvise-bad) mmap 2 anonymous pages
+(madvise-bad) madvise misaligned address (must fail)
+(madvise-bad) madvise zero length (must fail)
+(madvise-bad) madvise bad advice (must fail)
+(madvise-bad) madvise unmapped range (must fail)
+(madvise-bad) madvise kernel address (must fail)
+(madvise-bad) madvise MADV_SEQUENTIAL
+(madvise-bad) madvise MADV_RANDOM
+(madvise-bad) madvise range larger than the mapping
+(madvise-bad) end
+EOF
+pass;
@@ -0,0 +1,53 @@
+/* Drops pages with madvise(MADV_DONTNEED).  Anonymous pages must come
+   back zeroed, while a file mapping must be reloaded from the file,
+   including what was written to it before the pages were dropped. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/vm/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define ANON_PAGES 4
+#define ANON ((char *) 0x10000000)
+#define FILE ((char *) 0x20000000)
+
+static const char change[] = "madvise";
+
+void
+test_main (void)
+{
+	int handle;
+	size_t i;
+
+	CHECK (mmap (ANON, ANON_PAGES * PAGE_SIZE, 1, -1, 0) == ANON,
+			"mmap %d anonymous pages", ANON_PAGES);
+	for (i = 0; i < ANON_PAGES; i++)
+		memset (ANON + i * PAGE_SIZE, 'a' + i, PAGE_SIZE);
+	CHECK (madvise (ANON + PAGE_SIZE, 2 * PAGE_SIZE, MADV_DONTNEED) == 0,
+			"madvise pages 1-2 MADV_DONTNEED");
+
+	msg ("check anonymous pages");
+	for (i = 0; i < ANON_PAGES * PAGE_SIZE; i++) {
+		char expected = i / PAGE_SIZE == 1 || i / PAGE_SIZE == 2
+				? 0 : 'a' + (char) (i / PAGE_SIZE);
+		if (ANON[i] != expected)
+			fail ("byte %zu of anonymous mapping has value %02hhx (should be %02hhx)",
+					i, ANON[i], expected);
+	}
+
+	CHECK ((handle = open ("sample.txt")) > 1, "open \"sample.txt\"");
+	CHECK (mmap (FILE, PAGE_SIZE, 1, handle, 0) == FILE, "mmap \"sample.txt\"");
+	memcpy (FILE, change, strlen (change));
+	CHECK (madvise (FILE, PAGE_SIZE, MADV_DONTNEED) == 0,
+			"madvise \"sample.txt\" MADV_DONTNEED");
+	CHECK (!memcmp (FILE, change, strlen (change))
+			&& !memcmp (FILE + strlen (change), sample + strlen (change),
+					strlen (sample) - strlen (change)),
+			"check that written data was kept");
+
+	munmap (FILE);
+	munmap (ANON);
+	close (handle);
+}
@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(madvise-dontneed) begin
+(madvise-dontneed) mmap 4 anonymous pages
+(madvise-dontneed) madvise pages 1-2 MADV_DONTNEED
+(madvise-dontneed) check anonymous pages
+(madvise-dontneed) open "sample.txt"
+(madvise-dontneed) mmap "sample.txt"
+(madvise-dontneed) madvise "sample.txt" MADV_DONTNEED
+(madvise-dontneed) check that written data was kept
+(madvise-dontneed) end
+EOF
+pass;
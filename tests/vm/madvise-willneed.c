@@ -0,0 +1,38 @@
+/* Asks for file pages in advance with madvise(MADV_WILLNEED) and
+   checks that they are loaded before they are ever touched. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define MAP_PAGES 8
+#define ACTUAL ((char *) 0x10000000)
+
+void
+test_main (void)
+{
+	const char *text = "Lorem ipsum";
+	int handle;
+	size_t i;
+
+	CHECK ((handle = open ("large.txt")) > 1, "open \"large.txt\"");
+	CHECK (mmap (ACTUAL, MAP_PAGES * PAGE_SIZE, 0, handle, 0) == ACTUAL,
+			"mmap %d pages of \"large.txt\"", MAP_PAGES);
+
+	msg ("initial pages status");
+	for (i = 0; i < MAP_PAGES; i++)
+		CHECK (get_phys_addr (ACTUAL + i * PAGE_SIZE) == 0,
+				"check if page is not loaded");
+
+	CHECK (madvise (ACTUAL, MAP_PAGES * PAGE_SIZE, MADV_WILLNEED) == 0,
+			"madvise MADV_WILLNEED");
+	for (i = 0; i < MAP_PAGES; i++)
+		CHECK (get_phys_addr (ACTUAL + i * PAGE_SIZE) != 0,
+				"check if page is loaded");
+	CHECK (!memcmp (ACTUAL, text, strlen (text)), "check memory content");
+
+	munmap (ACTUAL);
+	close (handle);
+}
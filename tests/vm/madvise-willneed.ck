@@ -0,0 +1,30 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(madvise-willneed) begin
+(madvise-willneed) open "large.txt"
+(madvise-willneed) mmap 8 pages of "large.txt"
+(madvise-willneed) initial pages status
+(madvise-willneed) check if page is not loaded
+(madvise-willneed) check if page is not loaded
+(madvise-willneed) check if page is not loaded
+(madvise-willneed) check if page is not loaded
+(madvise-willneed) check if page is not loaded
+(madvise-willneed) check if page is not loaded
+(madvise-willneed) check if page is not loaded
+(madvise-willneed) check if page is not loaded
+(madvise-willneed) madvise MADV_WILLNEED
+(madvise-willneed) check if page is loaded
+(madvise-willneed) check if page is loaded
+(madvise-willneed) check if page is loaded
+(madvise-willneed) check if page is loaded
+(madvise-willneed) check if page is loaded
+(madvise-willneed) check if page is loaded
+(madvise-willneed) check if page is loaded
+(madvise-willneed) check if page is loaded
+(madvise-willneed) check memory content
+(madvise-willneed) end
+EOF
+pass;
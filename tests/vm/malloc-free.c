@@ -0,0 +1,87 @@
+/* Exercises the user-space allocator on top of sbrk(): many blocks of
+   different sizes must not overlap, realloc() must keep the old data,
+   calloc() must zero its block, and freed memory must be reused
+   instead of growing the heap. */
+
+#include <malloc.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define BLOCK_CNT 64
+#define LARGE_SIZE (64 * 1024)
+
+static char *blocks[BLOCK_CNT];
+
+static size_t
+block_size (size_t i)
+{
+	return i * 37 + 1;
+}
+
+static void
+check_block (size_t i, size_t size)
+{
+	size_t j;
+
+	for (j = 0; j < size; j++)
+		if (blocks[i][j] != (char) i)
+			fail ("byte %zu of block %zu has value %02hhx (should be %02hhx)",
+					j, i, blocks[i][j], (char) i);
+}
+
+void
+test_main (void)
+{
+	char *p, *brk;
+	size_t i;
+
+	msg ("malloc %d blocks", BLOCK_CNT);
+	for (i = 0; i < BLOCK_CNT; i++) {
+		blocks[i] = malloc (block_size (i));
+		if (blocks[i] == NULL)
+			fail ("malloc of block %zu failed", i);
+		memset (blocks[i], i, block_size (i));
+	}
+	msg ("check blocks");
+	for (i = 0; i < BLOCK_CNT; i++)
+		check_block (i, block_size (i));
+
+	msg ("free odd blocks, realloc even blocks");
+	for (i = 0; i < BLOCK_CNT; i++) {
+		if (i % 2) {
+			free (blocks[i]);
+			blocks[i] = NULL;
+			continue;
+		}
+		p = realloc (blocks[i], block_size (i) * 4);
+		if (p == NULL)
+			fail ("realloc of block %zu failed", i);
+		blocks[i] = p;
+		memset (blocks[i] + block_size (i), i, block_size (i) * 3);
+	}
+	msg ("check blocks");
+	for (i = 0; i < BLOCK_CNT; i += 2)
+		check_block (i, block_size (i) * 4);
+
+	CHECK ((p = calloc (100, 40)) != NULL, "calloc 100 x 40 bytes");
+	for (i = 0; i < 100 * 40; i++)
+		if (p[i] != 0)
+			fail ("byte %zu of calloc'd block has value %02hhx (should be 0)",
+					i, p[i]);
+	free (p);
+
+	CHECK ((p = malloc (LARGE_SIZE)) != NULL, "malloc %d bytes", LARGE_SIZE);
+	memset (p, 'x', LARGE_SIZE);
+	free (p);
+
+	msg ("free all blocks");
+	for (i = 0; i < BLOCK_CNT; i++)
+		free (blocks[i]);
+
+	brk = sbrk (0);
+	CHECK ((p = malloc (LARGE_SIZE)) != NULL, "malloc %d bytes again", LARGE_SIZE);
+	CHECK (sbrk (0) == brk, "freed memory is reused");
+	free (p);
+}
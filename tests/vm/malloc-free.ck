@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(malloc-free) begin
+(malloc-free) malloc 64 blocks
+(malloc-free) check blocks
+(malloc-free) free odd blocks, realloc even blocks
+(malloc-free) check blocks
+(malloc-free) calloc 100 x 40 bytes
+(malloc-free) malloc 65536 bytes
+(malloc-free) free all blocks
+(malloc-free) malloc 65536 bytes again
+(malloc-free) freed memory is reused
+(malloc-free) end
+EOF
+pass;
@@ -0,0 +1,53 @@
+/* Maps anonymous memory by passing fd -1 to mmap() and checks that
+   it starts out zeroed, keeps what is written to it, cannot be
+   mapped over, and comes back zeroed after munmap() and mmap(). */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define MAP_PAGES 3
+#define MAP_SIZE (MAP_PAGES * PAGE_SIZE)
+#define ACTUAL ((char *) 0x10000000)
+
+static void
+check_zeros (void)
+{
+	size_t i;
+
+	msg ("check that mapping is zeroed");
+	for (i = 0; i < MAP_SIZE; i++)
+		if (ACTUAL[i] != 0)
+			fail ("byte %zu of anonymous mapping has value %02hhx (should be 0)",
+					i, ACTUAL[i]);
+}
+
+void
+test_main (void)
+{
+	void *map;
+	size_t i;
+
+	CHECK ((map = mmap (ACTUAL, MAP_SIZE, 1, -1, 0)) == ACTUAL,
+			"mmap %d anonymous pages", MAP_PAGES);
+	check_zeros ();
+
+	msg ("write mapping");
+	for (i = 0; i < MAP_PAGES; i++)
+		memset (ACTUAL + i * PAGE_SIZE, 'a' + i, PAGE_SIZE);
+	for (i = 0; i < MAP_SIZE; i++)
+		if (ACTUAL[i] != 'a' + (char) (i / PAGE_SIZE))
+			fail ("byte %zu of anonymous mapping has value %02hhx (should be %02hhx)",
+					i, ACTUAL[i], 'a' + (char) (i / PAGE_SIZE));
+
+	CHECK (mmap (ACTUAL + PAGE_SIZE, PAGE_SIZE, 1, -1, 0) == MAP_FAILED,
+			"mmap over anonymous mapping (must fail)");
+
+	munmap (map);
+	CHECK ((map = mmap (ACTUAL, MAP_SIZE, 1, -1, 0)) == ACTUAL,
+			"mmap %d anonymous pages again", MAP_PAGES);
+	check_zeros ();
+	munmap (map);
+}
@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-anon) begin
+(mmap-anon) mmap 3 anonymous pages
+(mmap-anon) check that mapping is zeroed
+(mmap-anon) write mapping
+(mmap-anon) mmap over anonymous mapping (must fail)
+(mmap-anon) mmap 3 anonymous pages again
+(mmap-anon) check that mapping is zeroed
+(mmap-anon) end
+EOF
+pass;
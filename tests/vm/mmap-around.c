@@ -0,0 +1,98 @@
+/* Checks fault-around on file mappings.  A fault on the first page of
+   a mapping also loads the following pages of the same 8-page window,
+   with the right contents, but never pages of the next mapping, pages
+   past the end of the file, or pages of a mapping advised with
+   MADV_RANDOM. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define WINDOW 8				/* FAULT_AROUND_PAGES */
+#define REGION_PAGES 5			/* first mapping; the second fills the window */
+#define SMALL_PAGES 3			/* small.txt is 10016 bytes */
+#define NEXT ((char *) 0x10000000 + REGION_PAGES * PAGE_SIZE)
+
+static char buf[PAGE_SIZE];
+
+/* Returns true if page I of MAP is mapped. */
+static bool
+loaded (char *map, size_t i)
+{
+	return get_phys_addr (map + i * PAGE_SIZE) != NULL;
+}
+
+/* Checks that page I of MAP holds page OFS of the file open as HANDLE. */
+static void
+check_page (char *map, size_t i, int handle, size_t ofs)
+{
+	memset (buf, 0, sizeof buf);
+	seek (handle, ofs * PAGE_SIZE);
+	read (handle, buf, PAGE_SIZE);
+	if (memcmp (map + i * PAGE_SIZE, buf, PAGE_SIZE))
+		fail ("page %zu of the mapping at %p differs from the file", i, map);
+}
+
+void
+test_main (void)
+{
+	char *map = (char *) 0x10000000;
+	char *small_map = (char *) 0x20000000;
+	char *random_map = (char *) 0x30000000;
+	int handle, small;
+	size_t i;
+
+	CHECK ((handle = open ("large.txt")) > 1, "open \"large.txt\"");
+	CHECK (mmap (map, REGION_PAGES * PAGE_SIZE, 0, handle, 0) == map,
+			"mmap \"large.txt\"");
+	CHECK (mmap (NEXT, (WINDOW - REGION_PAGES) * PAGE_SIZE, 0, handle,
+				REGION_PAGES * PAGE_SIZE) == NEXT,
+			"mmap the rest of the window");
+
+	/* 첫 page만 건드려도 region 안의 이웃 page가 함께 올라와야 함 */
+	check_page (map, 0, handle, 0);
+	for (i = 1; i < REGION_PAGES; i++)
+		if (!loaded (map, i))
+			fail ("page %zu was not faulted around", i);
+	msg ("neighbouring pages are loaded");
+	for (i = REGION_PAGES; i < WINDOW; i++)
+		if (loaded (map, i))
+			fail ("page %zu of the next mapping was loaded", i);
+	msg ("next mapping is untouched");
+	for (i = 1; i < WINDOW; i++)
+		check_page (map, i, handle, i);
+	msg ("window holds the file's data");
+
+	/* 파일 끝 뒤의 page는 0 page이므로 미리 읽지 않음 */
+	CHECK ((small = open ("small.txt")) > 1, "open \"small.txt\"");
+	CHECK (mmap (small_map, WINDOW * PAGE_SIZE, 0, small, 0) == small_map,
+			"mmap \"small.txt\" past its end");
+	check_page (small_map, 0, small, 0);
+	for (i = 1; i < WINDOW; i++)
+		if (loaded (small_map, i) != (i < SMALL_PAGES))
+			fail ("page %zu: loaded is %d", i, loaded (small_map, i));
+	msg ("pages past EOF are untouched");
+	for (i = 1; i < WINDOW; i++)
+		check_page (small_map, i, small, i);
+	msg ("pages past EOF read as zeros");
+
+	/* MADV_RANDOM이면 fault-around를 하지 않음 */
+	CHECK (mmap (random_map, WINDOW * PAGE_SIZE, 0, handle, WINDOW * PAGE_SIZE)
+			== random_map, "mmap the next window of \"large.txt\"");
+	CHECK (madvise (random_map, WINDOW * PAGE_SIZE, MADV_RANDOM) == 0,
+			"madvise MADV_RANDOM");
+	check_page (random_map, WINDOW - 1, handle, 2 * WINDOW - 1);
+	for (i = 0; i < WINDOW - 1; i++)
+		if (loaded (random_map, i))
+			fail ("page %zu was faulted around despite MADV_RANDOM", i);
+	msg ("MADV_RANDOM disables fault-around");
+
+	munmap (random_map);
+	munmap (small_map);
+	munmap (NEXT);
+	munmap (map);
+	close (small);
+	close (handle);
+}
@@ -0,0 +1,22 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-around) begin
+(mmap-around) open "large.txt"
+(mmap-around) mmap "large.txt"
+(mmap-around) mmap the rest of the window
+(mmap-around) neighbouring pages are loaded
+(mmap-around) next mapping is untouched
+(mmap-around) window holds the file's data
+(mmap-around) open "small.txt"
+(mmap-around) mmap "small.txt" past its end
+(mmap-around) pages past EOF are untouched
+(mmap-around) pages past EOF read as zeros
+(mmap-around) mmap the next window of "large.txt"
+(mmap-around) madvise MADV_RANDOM
+(mmap-around) MADV_RANDOM disables fault-around
+(mmap-around) end
+EOF
+pass;
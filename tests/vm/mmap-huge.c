@@ -0,0 +1,61 @@
+/* Maps 512 MB of a file, far more than memory, and checks that the
+   mapping costs no resident pages until it is touched and that touching
+   a few pages only brings those in.  Then checks that mappings which
+   overlap an existing one at either of its ends, or span the gap
+   between two, are rejected while the gap itself can be mapped. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define HUGE_SIZE (512 * 1024 * 1024)
+#define HUGE ((char *) 0x10000000)
+#define SLACK 32			/* fault-around과 page table 등을 위한 여유 */
+#define ADDR(N) ((char *) 0x40000000 + (N) * PAGE_SIZE)
+
+void
+test_main (void)
+{
+	size_t rss;
+	int handle;
+
+	CHECK ((handle = open ("large.txt")) > 1, "open \"large.txt\"");
+	rss = get_rss ();
+	CHECK (mmap (HUGE, HUGE_SIZE, 0, handle, 0) == HUGE, "mmap 512 MB of \"large.txt\"");
+	CHECK (get_rss () <= rss + SLACK, "mmap loads no pages");
+
+	/* 파일 앞부분, 파일 끝 뒤의 0 page, 마지막 page */
+	CHECK (HUGE[0] == 'L', "read the first page");
+	CHECK (HUGE[HUGE_SIZE / 2] == '\0', "read a page past EOF");
+	CHECK (HUGE[HUGE_SIZE - 1] == '\0', "read the last page");
+	CHECK (get_rss () <= rss + SLACK, "only touched pages are resident");
+
+	/* 한가운데에 겹치게 매핑할 수 없음 */
+	CHECK (mmap (HUGE + HUGE_SIZE / 2, PAGE_SIZE, 0, handle, 0) == MAP_FAILED,
+			"mmap inside the huge mapping fails");
+	munmap (HUGE);
+	CHECK (get_rss () <= rss + SLACK, "munmap");
+
+	/* [0, 4)과 [8, 12) 두 region 사이와 양 끝을 걸치는 매핑 */
+	CHECK (mmap (ADDR (0), 4 * PAGE_SIZE, 0, handle, 0) == ADDR (0), "mmap pages 0-3");
+	CHECK (mmap (ADDR (8), 4 * PAGE_SIZE, 0, handle, 0) == ADDR (8), "mmap pages 8-11");
+	CHECK (mmap (ADDR (2), 4 * PAGE_SIZE, 0, handle, 0) == MAP_FAILED,
+			"mmap over the end of pages 0-3 fails");
+	CHECK (mmap (ADDR (6), 4 * PAGE_SIZE, 0, handle, 0) == MAP_FAILED,
+			"mmap over the start of pages 8-11 fails");
+	CHECK (mmap (ADDR (3), 6 * PAGE_SIZE, 0, handle, 0) == MAP_FAILED,
+			"mmap across the gap fails");
+	CHECK (mmap (ADDR (7), 6 * PAGE_SIZE, 0, handle, 0) == MAP_FAILED,
+			"mmap around pages 8-11 fails");
+	CHECK (mmap (ADDR (4), 4 * PAGE_SIZE, 0, handle, 0) == ADDR (4),
+			"mmap the gap, pages 4-7");
+	CHECK (!memcmp (ADDR (0), ADDR (4), PAGE_SIZE) && !memcmp (ADDR (4), ADDR (8), PAGE_SIZE),
+			"all three mappings read the file");
+
+	munmap (ADDR (8));
+	munmap (ADDR (4));
+	munmap (ADDR (0));
+	close (handle);
+}
@@ -0,0 +1,26 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-huge) begin
+(mmap-huge) open "large.txt"
+(mmap-huge) mmap 512 MB of "large.txt"
+(mmap-huge) mmap loads no pages
+(mmap-huge) read the first page
+(mmap-huge) read a page past EOF
+(mmap-huge) read the last page
+(mmap-huge) only touched pages are resident
+(mmap-huge) mmap inside the huge mapping fails
+(mmap-huge) munmap
+(mmap-huge) mmap pages 0-3
+(mmap-huge) mmap pages 8-11
+(mmap-huge) mmap over the end of pages 0-3 fails
+(mmap-huge) mmap over the start of pages 8-11 fails
+(mmap-huge) mmap across the gap fails
+(mmap-huge) mmap around pages 8-11 fails
+(mmap-huge) mmap the gap, pages 4-7
+(mmap-huge) all three mappings read the file
+(mmap-huge) end
+EOF
+pass;
@@ -0,0 +1,57 @@
+/* Maps a file, forks, and checks that parent and child share the
+   mapped frame: writes through either mapping, and write() calls on
+   the file, are seen by the other process at once. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define ACTUAL ((char *) 0x10000000)
+#define CHILD_OFS 1024
+#define WRITE_OFS 2048
+
+static const char parent_data[] = "written by the parent";
+static const char child_data[] = "written by the child";
+static const char write_data[] = "written with write()";
+
+void
+test_main (void)
+{
+	char buf[sizeof child_data];
+	void *pa;
+	int handle;
+	pid_t child;
+
+	CHECK (create ("shared.txt", PAGE_SIZE), "create \"shared.txt\"");
+	CHECK ((handle = open ("shared.txt")) > 1, "open \"shared.txt\"");
+	CHECK (mmap (ACTUAL, PAGE_SIZE, 1, handle, 0) == ACTUAL, "mmap \"shared.txt\"");
+	memcpy (ACTUAL, parent_data, sizeof parent_data);
+	pa = get_phys_addr (ACTUAL);
+
+	child = fork ("child");
+	if (child == 0) {
+		CHECK (!memcmp (ACTUAL, parent_data, sizeof parent_data),
+				"child sees the parent's data");
+		CHECK (get_phys_addr (ACTUAL) == pa, "child maps the parent's frame");
+		memcpy (ACTUAL + CHILD_OFS, child_data, sizeof child_data);
+		seek (handle, WRITE_OFS);
+		CHECK (write (handle, write_data, sizeof write_data) == (int) sizeof write_data,
+				"write \"shared.txt\"");
+		return;
+	}
+	wait (child);
+
+	CHECK (!memcmp (ACTUAL + CHILD_OFS, child_data, sizeof child_data),
+			"parent sees the child's write through the mapping");
+	CHECK (!memcmp (ACTUAL + WRITE_OFS, write_data, sizeof write_data),
+			"parent sees the child's write()");
+	seek (handle, CHILD_OFS);
+	read (handle, buf, sizeof child_data);
+	CHECK (!memcmp (buf, child_data, sizeof child_data),
+			"read() sees the child's write through the mapping");
+
+	munmap (ACTUAL);
+	close (handle);
+}
@@ -0,0 +1,19 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-shared) begin
+(mmap-shared) create "shared.txt"
+(mmap-shared) open "shared.txt"
+(mmap-shared) mmap "shared.txt"
+(mmap-shared) child sees the parent's data
+(mmap-shared) child maps the parent's frame
+(mmap-shared) write "shared.txt"
+(mmap-shared) end
+(mmap-shared) parent sees the child's write through the mapping
+(mmap-shared) parent sees the child's write()
+(mmap-shared) read() sees the child's write through the mapping
+(mmap-shared) end
+EOF
+pass;
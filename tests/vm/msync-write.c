@@ -0,0 +1,42 @@
+/* Writes to a file through a mapping, pushes the change to the file
+   with msync() while the mapping is still in place, and reads it back
+   with the read system call.  Also checks that msync() fails on
+   ranges that hold no file mapping. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/vm/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define ACTUAL ((char *) 0x10000000)
+#define ANON ((char *) 0x20000000)
+
+void
+test_main (void)
+{
+	int handle;
+	char buf[1024];
+
+	CHECK (create ("sample.txt", strlen (sample)), "create \"sample.txt\"");
+	CHECK ((handle = open ("sample.txt")) > 1, "open \"sample.txt\"");
+	CHECK (mmap (ACTUAL, PAGE_SIZE, 1, handle, 0) == ACTUAL, "mmap \"sample.txt\"");
+	memcpy (ACTUAL, sample, strlen (sample));
+	CHECK (msync (ACTUAL, PAGE_SIZE) == 0, "msync \"sample.txt\"");
+
+	read (handle, buf, strlen (sample));
+	CHECK (!memcmp (buf, sample, strlen (sample)),
+			"compare read data against written data");
+
+	CHECK (mmap (ANON, PAGE_SIZE, 1, -1, 0) == ANON, "mmap anonymous page");
+	CHECK (msync (ANON, PAGE_SIZE) == -1, "msync anonymous page (must fail)");
+	CHECK (msync ((void *) 0x30000000, PAGE_SIZE) == -1,
+			"msync unmapped range (must fail)");
+	CHECK (msync (ACTUAL + 1, PAGE_SIZE) == -1,
+			"msync misaligned address (must fail)");
+
+	munmap (ANON);
+	munmap (ACTUAL);
+	close (handle);
+}
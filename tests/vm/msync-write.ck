@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(msync-write) begin
+(msync-write) create "sample.txt"
+(msync-write) open "sample.txt"
+(msync-write) mmap "sample.txt"
+(msync-write) msync "sample.txt"
+(msync-write) compare read data against written data
+(msync-write) mmap anonymous page
+(msync-write) msync anonymous page (must fail)
+(msync-write) msync unmapped range (must fail)
+(msync-write) msync misaligned address (must fail)
+(msync-write) end
+EOF
+pass;
@@ -0,0 +1,45 @@
+/* Reads untouched anonymous pages and checks that they all map the
+   same zero-filled frame until one of them is written, which gives
+   that page a private frame of its own. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define MAP_PAGES 4
+#define ACTUAL ((char *) 0x10000000)
+
+void
+test_main (void)
+{
+	void *pa[MAP_PAGES];
+	size_t i, j;
+
+	CHECK (mmap (ACTUAL, MAP_PAGES * PAGE_SIZE, 1, -1, 0) == ACTUAL,
+			"mmap %d anonymous pages", MAP_PAGES);
+
+	msg ("read pages");
+	for (i = 0; i < MAP_PAGES; i++)
+		for (j = 0; j < PAGE_SIZE; j++)
+			if (ACTUAL[i * PAGE_SIZE + j] != 0)
+				fail ("byte %zu of page %zu has value %02hhx (should be 0)",
+						j, i, ACTUAL[i * PAGE_SIZE + j]);
+
+	for (i = 0; i < MAP_PAGES; i++)
+		pa[i] = get_phys_addr (ACTUAL + i * PAGE_SIZE);
+	CHECK (pa[0] != 0, "check if page is loaded");
+	for (i = 1; i < MAP_PAGES; i++)
+		CHECK (pa[i] == pa[0], "page %zu shares the zero frame", i);
+
+	msg ("write page 1");
+	ACTUAL[PAGE_SIZE] = 'x';
+	CHECK (get_phys_addr (ACTUAL + PAGE_SIZE) != pa[0],
+			"page 1 has a frame of its own");
+	CHECK (get_phys_addr (ACTUAL) == pa[0]
+			&& get_phys_addr (ACTUAL + 2 * PAGE_SIZE) == pa[0],
+			"other pages still share the zero frame");
+	CHECK (ACTUAL[PAGE_SIZE] == 'x' && ACTUAL[0] == 0
+			&& ACTUAL[2 * PAGE_SIZE] == 0, "check memory content");
+}
@@ -0,0 +1,19 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(page-zero) begin
+(page-zero) mmap 4 anonymous pages
+(page-zero) read pages
+(page-zero) check if page is loaded
+(page-zero) page 1 shares the zero frame
+(page-zero) page 2 shares the zero frame
+(page-zero) page 3 shares the zero frame
+(page-zero) write page 1
+(page-zero) page 1 has a frame of its own
+(page-zero) other pages still share the zero frame
+(page-zero) check memory content
+(page-zero) end
+EOF
+pass;
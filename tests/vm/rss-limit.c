@@ -0,0 +1,39 @@
+/* Caps the resident set with set_rss_limit(), touches more pages than
+   the limit allows, and checks that get_rss() stays within the limit
+   while every page keeps its data. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define RSS_LIMIT 16
+#define BUF_PAGES (RSS_LIMIT * 4)
+
+static char buf[BUF_PAGES * PAGE_SIZE];
+
+void
+test_main (void)
+{
+	size_t i;
+
+	set_rss_limit (RSS_LIMIT);
+	CHECK (get_rss () <= RSS_LIMIT, "rss within limit after set_rss_limit");
+
+	msg ("write %d pages", BUF_PAGES);
+	for (i = 0; i < BUF_PAGES; i++)
+		memset (buf + i * PAGE_SIZE, i, PAGE_SIZE);
+	CHECK (get_rss () <= RSS_LIMIT, "rss within limit after writing");
+
+	msg ("check %d pages", BUF_PAGES);
+	for (i = 0; i < sizeof buf; i++)
+		if (buf[i] != (char) (i / PAGE_SIZE))
+			fail ("byte %zu of buf has value %02hhx (should be %02hhx)",
+					i, buf[i], (char) (i / PAGE_SIZE));
+	CHECK (get_rss () <= RSS_LIMIT, "rss within limit after reading");
+
+	set_rss_limit (0);
+	memset (buf, 0xff, sizeof buf);
+	CHECK (get_rss () > RSS_LIMIT, "rss grows again without a limit");
+}
@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(rss-limit) begin
+(rss-limit) rss within limit after set_rss_limit
+(rss-limit) write 64 pages
+(rss-limit) rss within limit after writing
+(rss-limit) check 64 pages
+(rss-limit) rss within limit after reading
+(rss-limit) rss grows again without a limit
+(rss-limit) end
+EOF
+pass;
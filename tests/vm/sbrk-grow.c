@@ -0,0 +1,51 @@
+/* Grows the heap with sbrk(), fills it, then shrinks it and grows
+   it again to check that the pages that were given back come back
+   zeroed while the rest of the heap keeps its data. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define HEAP_PAGES 4
+#define HEAP_SIZE (HEAP_PAGES * PAGE_SIZE)
+#define KEEP_SIZE (HEAP_SIZE / 2)
+
+void
+test_main (void)
+{
+	char *heap;
+	size_t i;
+
+	CHECK ((heap = sbrk (0)) != (void *) -1, "sbrk (0)");
+	CHECK (sbrk (HEAP_SIZE) == heap, "grow heap by %d pages", HEAP_PAGES);
+	CHECK ((char *) sbrk (0) == heap + HEAP_SIZE, "check new break");
+
+	msg ("write heap");
+	for (i = 0; i < HEAP_SIZE; i++)
+		heap[i] = i % 251;
+	for (i = 0; i < HEAP_SIZE; i++)
+		if (heap[i] != (char) (i % 251))
+			fail ("byte %zu of heap has value %02hhx (should be %02hhx)",
+					i, heap[i], (char) (i % 251));
+
+	CHECK (sbrk (-(HEAP_SIZE - KEEP_SIZE)) == heap + HEAP_SIZE,
+			"shrink heap to %d pages", KEEP_SIZE / PAGE_SIZE);
+	CHECK (sbrk (HEAP_SIZE - KEEP_SIZE) == heap + KEEP_SIZE, "grow heap again");
+
+	msg ("check heap");
+	for (i = 0; i < KEEP_SIZE; i++)
+		if (heap[i] != (char) (i % 251))
+			fail ("byte %zu of heap has value %02hhx (should be %02hhx)",
+					i, heap[i], (char) (i % 251));
+	for (i = KEEP_SIZE; i < HEAP_SIZE; i++)
+		if (heap[i] != 0)
+			fail ("byte %zu of regrown heap has value %02hhx (should be 0)",
+					i, heap[i]);
+
+	CHECK (sbrk (-(HEAP_SIZE + PAGE_SIZE)) == (void *) -1,
+			"shrink heap below its start (must fail)");
+	CHECK (sbrk (-HEAP_SIZE) == heap + HEAP_SIZE, "release heap");
+	CHECK (sbrk (0) == heap, "check break is back at heap start");
+}
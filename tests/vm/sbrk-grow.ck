@@ -0,0 +1,19 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(sbrk-grow) begin
+(sbrk-grow) sbrk (0)
+(sbrk-grow) grow heap by 4 pages
+(sbrk-grow) check new break
+(sbrk-grow) write heap
+(sbrk-grow) shrink heap to 2 pages
+(sbrk-grow) grow heap again
+(sbrk-grow) check heap
+(sbrk-grow) shrink heap below its start (must fail)
+(sbrk-grow) release heap
+(sbrk-grow) check break is back at heap start
+(sbrk-grow) end
+EOF
+pass;
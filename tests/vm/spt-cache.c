@@ -0,0 +1,95 @@
+/* Checks that cached page lookups never outlive the page they point to.
+   An address is mapped to one file, used in write(), unmapped, mapped
+   to another file and then to anonymous memory, and dropped with
+   MADV_DONTNEED; after each step both user accesses and system calls
+   must see the new page.  Two pages that share a cache slot are also
+   used in turn. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define SLOTS 16			/* SPT_CACHE_SIZE */
+#define ADDR ((char *) 0x10000000)
+#define ALIAS (ADDR + SLOTS * PAGE_SIZE)
+
+static char buf[PAGE_SIZE];
+
+/* Returns true if all PAGE_SIZE bytes at P are C. */
+static bool
+all (const char *p, char c)
+{
+	size_t i;
+
+	for (i = 0; i < PAGE_SIZE; i++)
+		if (p[i] != c)
+			return false;
+	return true;
+}
+
+/* Creates NAME holding one page of C and returns it open. */
+static int
+make_file (const char *name, char c)
+{
+	int fd;
+
+	memset (buf, c, PAGE_SIZE);
+	CHECK (create (name, PAGE_SIZE), "create \"%s\"", name);
+	CHECK ((fd = open (name)) > 1, "open \"%s\"", name);
+	CHECK (write (fd, buf, PAGE_SIZE) == PAGE_SIZE, "write \"%s\"", name);
+	return fd;
+}
+
+void
+test_main (void)
+{
+	int a = make_file ("a.txt", 'a');
+	int b = make_file ("b.txt", 'b');
+	int out = make_file ("out.txt", 0);
+
+	CHECK (mmap (ADDR, PAGE_SIZE, 0, a, 0) == ADDR, "mmap \"a.txt\"");
+	seek (out, 0);
+	CHECK (write (out, ADDR, PAGE_SIZE) == PAGE_SIZE && all (ADDR, 'a'),
+			"write() from the mapping of \"a.txt\"");
+	munmap (ADDR);
+
+	/* 같은 주소를 다른 파일로 다시 매핑하면 새 page를 봐야 함 */
+	CHECK (mmap (ADDR, PAGE_SIZE, 0, b, 0) == ADDR, "mmap \"b.txt\" at the same address");
+	CHECK (all (ADDR, 'b'), "remapped page reads \"b.txt\"");
+	seek (out, 0);
+	write (out, ADDR, PAGE_SIZE);
+	seek (out, 0);
+	read (out, buf, PAGE_SIZE);
+	CHECK (all (buf, 'b'), "write() from the remapped page writes \"b.txt\"");
+	munmap (ADDR);
+
+	CHECK (mmap (ADDR, PAGE_SIZE, 1, -1, 0) == ADDR, "mmap anonymous memory at the same address");
+	CHECK (all (ADDR, 0), "anonymous page reads zeros");
+	seek (a, 0);
+	CHECK (read (a, ADDR, PAGE_SIZE) == PAGE_SIZE && all (ADDR, 'a'),
+			"read() into the anonymous page");
+
+	/* DONTNEED로 버린 page 대신 새 0 page가 보여야 함 */
+	CHECK (madvise (ADDR, PAGE_SIZE, MADV_DONTNEED) == 0, "madvise MADV_DONTNEED");
+	CHECK (all (ADDR, 0), "dropped page reads zeros");
+	seek (b, 0);
+	CHECK (read (b, ADDR, PAGE_SIZE) == PAGE_SIZE && all (ADDR, 'b'),
+			"read() into the dropped page");
+	munmap (ADDR);
+
+	/* 같은 slot을 쓰는 두 page를 번갈아 씀 */
+	CHECK (mmap (ADDR, (SLOTS + 1) * PAGE_SIZE, 1, -1, 0) == ADDR,
+			"mmap %d anonymous pages", SLOTS + 1);
+	memset (ADDR, 'x', PAGE_SIZE);
+	memset (ALIAS, 'y', PAGE_SIZE);
+	seek (a, 0);
+	read (a, ALIAS, PAGE_SIZE);
+	CHECK (all (ADDR, 'x') && all (ALIAS, 'a'), "pages sharing a cache slot stay apart");
+	munmap (ADDR);
+
+	close (out);
+	close (b);
+	close (a);
+}
@@ -0,0 +1,31 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(spt-cache) begin
+(spt-cache) create "a.txt"
+(spt-cache) open "a.txt"
+(spt-cache) write "a.txt"
+(spt-cache) create "b.txt"
+(spt-cache) open "b.txt"
+(spt-cache) write "b.txt"
+(spt-cache) create "out.txt"
+(spt-cache) open "out.txt"
+(spt-cache) write "out.txt"
+(spt-cache) mmap "a.txt"
+(spt-cache) write() from the mapping of "a.txt"
+(spt-cache) mmap "b.txt" at the same address
+(spt-cache) remapped page reads "b.txt"
+(spt-cache) write() from the remapped page writes "b.txt"
+(spt-cache) mmap anonymous memory at the same address
+(spt-cache) anonymous page reads zeros
+(spt-cache) read() into the anonymous page
+(spt-cache) madvise MADV_DONTNEED
+(spt-cache) dropped page reads zeros
+(spt-cache) read() into the dropped page
+(spt-cache) mmap 17 anonymous pages
+(spt-cache) pages sharing a cache slot stay apart
+(spt-cache) end
+EOF
+pass;
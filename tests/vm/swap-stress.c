@@ -0,0 +1,88 @@
+/* Pushes far more anonymous memory than fits in RAM through the swap
+   disk, with contents that do not compress so nearly every page is
+   written out.  The pages are read back in reverse and with a stride
+   of 17, which crosses the 8-page swap-out clusters and the 16-page
+   I/O batches at every offset, then every other page is rewritten and
+   the whole buffer is checked again.
+   For this test, Pintos memory size is 10MB. */
+
+#include <stdint.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SHIFT 12
+#define PAGE_SIZE (1 << PAGE_SHIFT)
+#define ONE_MB (1 << 20) // 1MB
+#define CHUNK_SIZE (24*ONE_MB)
+#define PAGE_COUNT (CHUNK_SIZE / PAGE_SIZE)
+#define STRIDE 17
+
+static uint32_t big_chunks[CHUNK_SIZE / sizeof (uint32_t)];
+
+/* Returns the first word of page I in round ROUND.  Each following word
+   is derived from the one before, so the page does not compress. */
+static uint32_t
+seed (size_t i, int round)
+{
+	return (uint32_t) i * 2654435761u + round;
+}
+
+static uint32_t *
+page (size_t i)
+{
+	return big_chunks + i * (PAGE_SIZE / sizeof (uint32_t));
+}
+
+static void
+fill_page (size_t i, int round)
+{
+	uint32_t *p = page (i);
+	uint32_t x = seed (i, round);
+	size_t j;
+
+	for (j = 0; j < PAGE_SIZE / sizeof (uint32_t); j++) {
+		p[j] = x;
+		x = x * 1664525u + 1013904223u;
+	}
+}
+
+static void
+check_page (size_t i, int round)
+{
+	uint32_t *p = page (i);
+	uint32_t x = seed (i, round);
+	size_t j;
+
+	for (j = 0; j < PAGE_SIZE / sizeof (uint32_t); j++) {
+		if (p[j] != x)
+			fail ("word %zu of page %zu is %08x (should be %08x)", j, i, p[j], x);
+		x = x * 1664525u + 1013904223u;
+	}
+}
+
+void
+test_main (void)
+{
+	size_t i, n;
+
+	msg ("write %d pages", PAGE_COUNT);
+	for (i = 0; i < PAGE_COUNT; i++)
+		fill_page (i, 1);
+
+	msg ("check pages in reverse");
+	for (i = PAGE_COUNT; i-- > 0; )
+		check_page (i, 1);
+
+	msg ("check pages with a stride of %d", STRIDE);
+	for (n = 0, i = 0; n < PAGE_COUNT; n++, i = (i + STRIDE) % PAGE_COUNT)
+		check_page (i, 1);
+
+	msg ("rewrite every other page");
+	for (i = 1; i < PAGE_COUNT; i += 2)
+		fill_page (i, 2);
+
+	msg ("check all pages");
+	for (i = 0; i < PAGE_COUNT; i++)
+		check_page (i, i % 2 ? 2 : 1);
+}
@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(swap-stress) begin
+(swap-stress) write 6144 pages
+(swap-stress) check pages in reverse
+(swap-stress) check pages with a stride of 17
+(swap-stress) rewrite every other page
+(swap-stress) check all pages
+(swap-stress) end
+EOF
+pass;
@@ -0,0 +1,69 @@
+/* Fills more anonymous memory than fits in RAM with four kinds of
+   pages: all zeros, repetitive text that compresses well, random
+   bytes that do not compress, and pages that are half random.  Once
+   they have been pushed out to zswap or to the swap disk and brought
+   back, every page must hold what was written to it.
+   For this test, Pintos memory size is 10MB. */
+
+#include <stdio.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/arc4.h"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SHIFT 12
+#define PAGE_SIZE (1 << PAGE_SHIFT)
+#define ONE_MB (1 << 20) // 1MB
+#define CHUNK_SIZE (20*ONE_MB)
+#define PAGE_COUNT (CHUNK_SIZE / PAGE_SIZE)
+
+enum kind { ZERO, TEXT, RANDOM, HALF, KIND_CNT };
+
+static char big_chunks[CHUNK_SIZE];
+static char expected[PAGE_SIZE];
+
+/* Writes the contents page I should have into PAGE. */
+static void
+fill_page (char *page, size_t i)
+{
+	struct arc4 arc4;
+	size_t ofs;
+
+	memset (page, 0, PAGE_SIZE);
+	switch (i % KIND_CNT) {
+	case ZERO:
+		/* 0만 써도 dirty page가 되어 ZSWAP_ZERO로 나감 */
+		break;
+	case TEXT:
+		for (ofs = 0; ofs + 32 <= PAGE_SIZE; ofs += 32)
+			snprintf (page + ofs, 32, "page %zu, offset %zu", i, ofs);
+		break;
+	case RANDOM:
+	case HALF:
+		/* 압축되지 않는 내용: ZSWAP_MAX_LEN을 넘기면 disk로 */
+		arc4_init (&arc4, &i, sizeof i);
+		arc4_crypt (&arc4, page, i % KIND_CNT == RANDOM ? PAGE_SIZE : PAGE_SIZE / 2);
+		break;
+	}
+}
+
+void
+test_main (void)
+{
+	size_t i;
+
+	for (i = 0; i < PAGE_COUNT; i++) {
+		if (!(i % 1024))
+			msg ("fill page %zu", i);
+		fill_page (big_chunks + i * PAGE_SIZE, i);
+	}
+
+	for (i = 0; i < PAGE_COUNT; i++) {
+		fill_page (expected, i);
+		if (memcmp (big_chunks + i * PAGE_SIZE, expected, PAGE_SIZE))
+			fail ("page %zu (kind %zu) is inconsistent", i, i % KIND_CNT);
+		if (!(i % 1024))
+			msg ("check page %zu", i);
+	}
+}
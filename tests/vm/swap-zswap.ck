@@ -0,0 +1,19 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(swap-zswap) begin
+(swap-zswap) fill page 0
+(swap-zswap) fill page 1024
+(swap-zswap) fill page 2048
+(swap-zswap) fill page 3072
+(swap-zswap) fill page 4096
+(swap-zswap) check page 0
+(swap-zswap) check page 1024
+(swap-zswap) check page 2048
+(swap-zswap) check page 3072
+(swap-zswap) check page 4096
+(swap-zswap) end
+EOF
+pass;
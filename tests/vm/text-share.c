@@ -0,0 +1,45 @@
+/* Runs this program again in two children with exec() and checks that
+   each child maps the parent's frame for its code, instead of reading
+   the executable into a frame of its own. */
+
+#include <debug.h>
+#include <stdint.h>
+#include <syscall.h>
+#include "tests/lib.h"
+
+#define CHILD_CNT 2
+
+const char *test_name = "text-share";
+
+/* Number of the frame holding this function's code. */
+static int
+text_frame (void)
+{
+	return (uintptr_t) get_phys_addr ((void *) text_frame) >> 12;
+}
+
+int
+main (int argc, char *argv[] UNUSED)
+{
+	int frame, i;
+
+	/* child: 자기 코드가 올라간 frame 번호를 exit code로 돌려줌 */
+	if (argc > 1)
+		return text_frame ();
+
+	msg ("begin");
+	frame = text_frame ();
+	for (i = 1; i <= CHILD_CNT; i++) {
+		pid_t child = fork ("text-share");
+
+		if (child == 0) {
+			exec ("text-share child");
+			fail ("exec \"text-share child\"");
+		}
+		if (child < 0)
+			fail ("fork() returned %d", child);
+		CHECK (wait (child) == frame, "child %d maps the parent's code frame", i);
+	}
+	msg ("end");
+	return 0;
+}
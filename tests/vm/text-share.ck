@@ -0,0 +1,11 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(text-share) begin
+(text-share) child 1 maps the parent's code frame
+(text-share) child 2 maps the parent's code frame
+(text-share) end
+EOF
+pass;
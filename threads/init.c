@@ -31,6 +31,7 @@
 #include "tests/threads/tests.h"
 #ifdef VM
 #include "vm/vm.h"
+#include "vm/evict.h"
 #endif
 #ifdef FILESYS
 #include "devices/disk.h"
@@ -57,6 +58,9 @@ static void paging_init (uint64_t mem_end);
 static char **read_command_line (void);
 static char **parse_options (char **argv);
 static void run_actions (char **argv);
+#ifdef VM
+static bool uses_scratch_disk (char **argv);
+#endif
 static void usage (void);
 
 static void print_stats (void);
@@ -76,6 +80,9 @@ main (void) {
 	/* Break command line into arguments and parse options. */
 	argv = read_command_line ();
 	argv = parse_options (argv);
+#ifdef VM
+	swap_scratch_busy = uses_scratch_disk (argv);
+#endif
 
 	/* Initialize ourselves as a thread so we can use locks,
 	   then enable console locking. */
@@ -155,6 +162,17 @@ paging_init (uint64_t mem_end) {
 	for (uint64_t pa = 0; pa < mem_end; pa += PGSIZE) {
 		uint64_t va = (uint64_t) ptov(pa);
 
+		// Whole 2 MB chunks that do not touch the read-only kernel text
+		// are mapped by a single PDE.
+		if (pa % LPGSIZE == 0 && pa + LPGSIZE <= mem_end
+				&& (va + LPGSIZE <= (uint64_t) &start
+					|| va >= (uint64_t) &_end_kernel_text)) {
+			if ((pte = pml4e_walk_large (pml4, va, 1)) != NULL)
+				*pte = pa | PTE_P | PTE_W | PTE_PS;
+			pa += LPGSIZE - PGSIZE;
+			continue;
+		}
+
 		perm = PTE_P | PTE_W;
 		if ((uint64_t) &start <= va && va < (uint64_t) &_end_kernel_text)
 			perm &= ~PTE_W;
@@ -226,6 +244,22 @@ parse_options (char **argv) {
 			user_page_limit = atoi (value);
 		else if (!strcmp (name, "-threads-tests"))
 			thread_tests = true;
+#endif
+#ifdef VM
+		else if (!strcmp (name, "-wm-low"))
+			reclaim_low_wm = atoi (value);
+		else if (!strcmp (name, "-wm-high"))
+			reclaim_high_wm = atoi (value);
+		else if (!strcmp (name, "-rss"))
+			rss_default_limit = atoi (value);
+		else if (!strcmp (name, "-swap")) {
+			if (!swap_set_disks (value))
+				PANIC ("bad swap disk list `%s'", value);
+		}
+		else if (!strcmp (name, "-evict")) {
+			if (!evict_policy_set (value))
+				PANIC ("unknown eviction policy `%s'", value);
+		}
 #endif
 		else
 			PANIC ("unknown option `%s' (use -h for help)", name);
@@ -299,6 +333,22 @@ run_actions (char **argv) {
 
 }
 
+#ifdef VM
+/* Returns true if the actions in ARGV include put or get, which read
+   and write the scratch disk (hd1:0). */
+static bool
+uses_scratch_disk (char **argv) {
+	for (; *argv != NULL; argv++) {
+		if (!strcmp (*argv, "put") || !strcmp (*argv, "get"))
+			return true;
+		/* ls만 인자가 없고 나머지 action은 인자 하나를 받음 */
+		if (strcmp (*argv, "ls") && argv[1] != NULL)
+			argv++;
+	}
+	return false;
+}
+#endif
+
 /* Prints a kernel command line help message and powers off the
    machine. */
 static void
@@ -328,6 +378,14 @@ usage (void) {
 			"  -mlfqs             Use multi-level feedback queue scheduler.\n"
 #ifdef USERPROG
 			"  -ul=COUNT          Limit user memory to COUNT pages.\n"
+#endif
+#ifdef VM
+			"  -wm-low=COUNT      Start background reclaim below COUNT free frames.\n"
+			"  -wm-high=COUNT     Stop background reclaim at COUNT free frames.\n"
+			"  -rss=COUNT         Limit each process to COUNT resident pages.\n"
+			"  -swap=C:D[,C:D]    Stripe swap over these channel 1 disks (default 1:1).\n"
+			"                     1:0 is the scratch disk; not usable with put/get.\n"
+			"  -evict=POLICY      Page replacement: clock (default), 2q, arc.\n"
 #endif
 			);
 	power_off ();
@@ -362,4 +420,7 @@ print_stats (void) {
 #ifdef USERPROG
 	exception_print_stats ();
 #endif
+#ifdef VM
+	evict_print_stats ();
+#endif
 }
\ No newline at end of file
@@ -23,6 +23,9 @@ pgdir_walk (uint64_t *pdp, const uint64_t va, int create) {
 			} else
 				return NULL;
 		}
+		/* A 2 MB mapping has no page table below it; the PDE is the leaf. */
+		if (pdp[idx] & PTE_PS)
+			return &pdp[idx];
 		return (uint64_t *) ptov (PTE_ADDR (pdp[idx]) + 8 * PTX (va));
 	}
 	return NULL;
@@ -88,6 +91,31 @@ pml4e_walk (uint64_t *pml4e, const uint64_t va, int create) {
 	return pte;
 }
 
+/* Returns the address of the page directory entry covering the 2 MB
+ * region that contains VA in PML4E, creating the upper levels if CREATE
+ * is true.  The caller installs a large page by storing
+ * PA | PTE_PS | flags into it; the entry must not already point to a
+ * page table. */
+uint64_t *
+pml4e_walk_large (uint64_t *pml4e, const uint64_t va, int create) {
+	uint64_t *table = pml4e;
+	int idx[2] = { PML4 (va), PDPE (va) };
+
+	for (int level = 0; level < 2; level++) {
+		uint64_t *entry = &table[idx[level]];
+		if (!(*entry & PTE_P)) {
+			if (!create)
+				return NULL;
+			uint64_t *new_page = palloc_get_page (PAL_ZERO);
+			if (new_page == NULL)
+				return NULL;
+			*entry = vtop (new_page) | PTE_U | PTE_W | PTE_P;
+		}
+		table = ptov (PTE_ADDR (*entry));
+	}
+	return &table[PDX (va)];
+}
+
 /* Creates a new page map level 4 (pml4) has mappings for kernel
  * virtual addresses, but none for user virtual addresses.
  * Returns the new page directory, or a null pointer if memory
@@ -122,10 +150,18 @@ pgdir_for_each (uint64_t *pdp, pte_for_each_func *func, void *aux,
 		unsigned pml4_index, unsigned pdp_index) {
 	for (unsigned i = 0; i < PGSIZE / sizeof(uint64_t *); i++) {
 		uint64_t *pte = ptov((uint64_t *) pdp[i]);
-		if (((uint64_t) pte) & PTE_P)
-			if (!pt_for_each ((uint64_t *) PTE_ADDR (pte), func, aux,
+		if (((uint64_t) pte) & PTE_P) {
+			if (pdp[i] & PTE_PS) {
+				/* 2 MB page: FUNC sees the PDE itself. */
+				void *va = (void *) (((uint64_t) pml4_index << PML4SHIFT) |
+									 ((uint64_t) pdp_index << PDPESHIFT) |
+									 ((uint64_t) i << PDXSHIFT));
+				if (!func (&pdp[i], va, aux))
+					return false;
+			} else if (!pt_for_each ((uint64_t *) PTE_ADDR (pte), func, aux,
 					pml4_index, pdp_index, i))
 				return false;
+		}
 	}
 	return true;
 }
@@ -169,7 +205,9 @@ static void
 pgdir_destroy (uint64_t *pdp) {
 	for (unsigned i = 0; i < PGSIZE / sizeof(uint64_t *); i++) {
 		uint64_t *pte = ptov((uint64_t *) pdp[i]);
-		if (((uint64_t) pte) & PTE_P)
+		/* A 2 MB mapping is not a page table, and its memory was not
+		 * handed out page by page, so there is nothing to free here. */
+		if ((((uint64_t) pte) & PTE_P) && !(pdp[i] & PTE_PS))
 			pt_destroy (PTE_ADDR (pte));
 	}
 	palloc_free_page ((void *) pdp);
@@ -216,8 +254,11 @@ pml4_get_page (uint64_t *pml4, const void *uaddr) {
 
 	uint64_t *pte = pml4e_walk (pml4, (uint64_t) uaddr, 0);
 
-	if (pte && (*pte & PTE_P))
+	if (pte && (*pte & PTE_P)) {
+		if (is_large_pte (pte))
+			return ptov (LPG_ADDR (*pte)) + ((uint64_t) uaddr & (LPGSIZE - 1));
 		return ptov (PTE_ADDR (*pte)) + pg_ofs (uaddr);
+	}
 	return NULL;
 }
 
@@ -313,3 +354,20 @@ pml4_set_accessed (uint64_t *pml4, const void *vpage, bool accessed) {
 			invlpg ((uint64_t) vpage);
 	}
 }
+
+/* Sets the writable bit to WRITABLE in the PTE for virtual page
+ * VPAGE in PML4.  Unlike pml4_set_page(), the accessed and dirty
+ * bits of the entry are preserved. */
+void
+pml4_set_writable (uint64_t *pml4, const void *vpage, bool writable) {
+	uint64_t *pte = pml4e_walk (pml4, (uint64_t) vpage, false);
+	if (pte) {
+		if (writable)
+			*pte |= PTE_W;
+		else
+			*pte &= ~(uint32_t) PTE_W;
+
+		if (rcr3 () == vtop (pml4))
+			invlpg ((uint64_t) vpage);
+	}
+}
@@ -328,6 +328,16 @@ palloc_free_page (void *page) {
 	palloc_free_multiple (page, 1);
 }
 
+/* Returns the number of pages in the user pool and stores the
+   kernel virtual address of its first page into *BASE.  Every page
+   handed out by palloc_get_page (PAL_USER) lies in
+   [*BASE, *BASE + PGSIZE * return value). */
+size_t
+palloc_user_pool (void **base) {
+	*base = user_pool.base;
+	return bitmap_size (user_pool.used_map);
+}
+
 /* Initializes pool P as starting at START and ending at END */
 static void
 init_pool (struct pool *p, void **bm_base, uint64_t start, uint64_t end) {
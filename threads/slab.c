@@ -0,0 +1,174 @@
+#include "threads/slab.h"
+#include <debug.h>
+#include <round.h>
+#include <stdint.h>
+#include "threads/palloc.h"
+#include "threads/vaddr.h"
+
+/* A typed object cache for small, fixed-size kernel objects.
+
+   malloc() serves every size through power-of-2 descriptors, so a
+   96-byte object takes a 128-byte block, and objects of unrelated
+   types end up sharing arenas.  A slab cache instead owns whole
+   pages ("slabs") that hold objects of exactly one size, packed
+   back to back after a small header.
+
+   Each slab keeps its own free list, so allocation pops the first
+   free object of the first partially used slab and freeing finds
+   the slab by rounding the object's address down to a page.  A
+   slab whose objects are all free is given back to the page
+   allocator, except for one that is kept so that a cache hovering
+   around a slab boundary does not repeatedly allocate and free
+   the same page.
+
+   The optional constructor runs on every object handed out, since
+   the free list link overwrites the start of a free object. */
+
+/* Magic number for detecting slab corruption. */
+#define SLAB_MAGIC 0x51ab51ab
+
+/* Slab header, at the start of each slab page. */
+struct slab {
+	unsigned magic;             /* Always set to SLAB_MAGIC. */
+	struct slab_cache *cache;   /* Owning cache. */
+	struct list_elem elem;      /* Element in cache's partial list. */
+	size_t in_use;              /* Objects handed out. */
+	struct free_obj *free;      /* First free object. */
+};
+
+/* Free object. */
+struct free_obj {
+	struct free_obj *next;      /* Next free object in the slab. */
+};
+
+#define SLAB_HDR_SIZE ROUND_UP (sizeof (struct slab), sizeof (void *))
+
+static struct slab *slab_create (struct slab_cache *);
+static struct slab *obj_to_slab (void *);
+
+/*** haein ***/
+/* Initializes CACHE to hand out objects of OBJ_SIZE bytes, each
+   passed to CTOR (if non-null) before it is returned. */
+void
+slab_cache_init (struct slab_cache *cache, const char *name, size_t obj_size,
+		void (*ctor) (void *)) {
+	obj_size = ROUND_UP (obj_size < sizeof (struct free_obj)
+			? sizeof (struct free_obj) : obj_size, sizeof (void *));
+	ASSERT (obj_size <= PGSIZE - SLAB_HDR_SIZE);
+
+	cache->name = name;
+	cache->obj_size = obj_size;
+	cache->objs_per_slab = (PGSIZE - SLAB_HDR_SIZE) / obj_size;
+	cache->ctor = ctor;
+	list_init (&cache->partial);
+	cache->slab_cnt = 0;
+	cache->has_empty = false;
+	lock_init (&cache->lock);
+}
+
+/*** haein ***/
+/* Obtains an object from CACHE and returns it, or a null pointer
+   if memory is not available. */
+void *
+slab_alloc (struct slab_cache *cache) {
+	struct slab *s;
+	struct free_obj *obj;
+
+	lock_acquire (&cache->lock);
+	if (list_empty (&cache->partial)) {
+		s = slab_create (cache);
+		if (s == NULL) {
+			lock_release (&cache->lock);
+			return NULL;
+		}
+		list_push_front (&cache->partial, &s->elem);
+	} else
+		s = list_entry (list_front (&cache->partial), struct slab, elem);
+
+	if (s->in_use == 0 && cache->has_empty)
+		cache->has_empty = false;
+
+	obj = s->free;
+	s->free = obj->next;
+	s->in_use++;
+	if (s->free == NULL)
+		list_remove (&s->elem);
+	lock_release (&cache->lock);
+
+	if (cache->ctor != NULL)
+		cache->ctor (obj);
+	return obj;
+}
+
+/*** haein ***/
+/* Returns OBJ, which must have come from CACHE, to it.  A null
+   OBJ is ignored, like free(). */
+void
+slab_free (struct slab_cache *cache, void *obj_) {
+	struct free_obj *obj = obj_;
+	struct slab *s;
+
+	if (obj == NULL)
+		return;
+
+	s = obj_to_slab (obj);
+	ASSERT (s->cache == cache);
+
+	lock_acquire (&cache->lock);
+	if (s->free == NULL)
+		list_push_front (&cache->partial, &s->elem);
+	obj->next = s->free;
+	s->free = obj;
+	s->in_use--;
+
+	if (s->in_use == 0) {
+		if (!cache->has_empty)
+			cache->has_empty = true;
+		else {
+			list_remove (&s->elem);
+			cache->slab_cnt--;
+			palloc_free_page (s);
+		}
+	}
+	lock_release (&cache->lock);
+}
+
+/*** haein ***/
+/* Allocates a new slab for CACHE with every object free.  Returns
+   a null pointer if the page allocator is out of memory.  Must
+   hold CACHE's lock. */
+static struct slab *
+slab_create (struct slab_cache *cache) {
+	struct slab *s = palloc_get_page (0);
+	size_t i;
+
+	if (s == NULL)
+		return NULL;
+
+	s->magic = SLAB_MAGIC;
+	s->cache = cache;
+	s->in_use = 0;
+	s->free = NULL;
+	for (i = cache->objs_per_slab; i-- > 0; ) {
+		struct free_obj *obj = (struct free_obj *)
+			((uint8_t *) s + SLAB_HDR_SIZE + i * cache->obj_size);
+		obj->next = s->free;
+		s->free = obj;
+	}
+	cache->slab_cnt++;
+	cache->has_empty = true;
+	return s;
+}
+
+/*** haein ***/
+/* Returns the slab that OBJ belongs to. */
+static struct slab *
+obj_to_slab (void *obj) {
+	struct slab *s = pg_round_down (obj);
+
+	ASSERT (s != NULL);
+	ASSERT (s->magic == SLAB_MAGIC);
+	ASSERT ((uintptr_t) obj - (uintptr_t) s >= SLAB_HDR_SIZE);
+	ASSERT (((uintptr_t) obj - (uintptr_t) s - SLAB_HDR_SIZE) % s->cache->obj_size == 0);
+	return s;
+}
@@ -564,6 +564,11 @@ init_thread (struct thread *t, const char *name, int priority) {
 
 	t->nice = NICE_DEFAULT;
 	t->recent_cpu = RECENT_CPU_DEFAULT;
+#ifdef VM
+	list_init(&t->frames);
+	t->rss = 0;
+	t->rss_limit = rss_default_limit;
+#endif
 }
 
 /* Chooses and returns the next thread to be scheduled.  Should
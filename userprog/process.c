@@ -193,6 +193,7 @@ __do_fork (void *aux) {
 
 	process_activate (current);
 #ifdef VM
+	current->rss_limit = parent->rss_limit;
 	supplemental_page_table_init (&current->spt);
 	if (!supplemental_page_table_copy (&current->spt, &parent->spt))
 		goto error;
@@ -536,6 +537,7 @@ load (const char *file_name, struct intr_frame *if_) {
 	struct file *file = NULL;
 	off_t file_ofs;
 	bool success = false;
+	uint8_t *heap_start = NULL;
 	int i;
 
 	/* Allocate and activate page directory. */
@@ -619,6 +621,9 @@ load (const char *file_name, struct intr_frame *if_) {
 					if (!load_segment (file, file_page, (void *) mem_page,
 								read_bytes, zero_bytes, writable))
 						goto done;
+					/* heap은 가장 높은 segment 바로 다음 page에서 시작 */
+					if ((uint8_t *) mem_page + read_bytes + zero_bytes > heap_start)
+						heap_start = (uint8_t *) mem_page + read_bytes + zero_bytes;
 				}
 				else
 					goto done;
@@ -630,6 +635,10 @@ load (const char *file_name, struct intr_frame *if_) {
 	if (!setup_stack (if_))
 		goto done;
 
+#ifdef VM
+	t->spt.heap_start = t->spt.brk = heap_start;
+#endif
+
 	/* Start address. */
 	if_->rip = ehdr.e_entry;
 
@@ -814,7 +823,7 @@ lazy_load_segment (struct page *page, void *aux) {
 	}
 
 	memset(page->frame->kva + seg_load->read_bytes, 0, PGSIZE - seg_load->read_bytes);
-	free(seg_load);
+	slab_free(&lazy_info_slab, seg_load);
 
 	return true;
 }
@@ -841,33 +850,11 @@ load_segment (struct file *file, off_t ofs, uint8_t *upage,
 	ASSERT ((read_bytes + zero_bytes) % PGSIZE == 0);
 	ASSERT (pg_ofs (upage) == 0);
 	ASSERT (ofs % PGSIZE == 0);
-	off_t now = ofs;
-	while (read_bytes > 0 || zero_bytes > 0) {
-		/* Do calculate how to fill this page.
-		 * We will read PAGE_READ_BYTES bytes from FILE
-		 * and zero the final PAGE_ZERO_BYTES bytes. */
-		size_t page_read_bytes = read_bytes < PGSIZE ? read_bytes : PGSIZE;
-		size_t page_zero_bytes = PGSIZE - page_read_bytes;
-
-		/* TODO: Set up aux to pass information to the lazy_load_segment. */
 
-		struct lazy_info *seg_info = malloc(sizeof(struct lazy_info));
-		seg_info->ofs = now;
-		seg_info->read_bytes = page_read_bytes;
-
-		if (!vm_alloc_page_with_initializer (VM_SEG, upage,
-					writable, lazy_load_segment, seg_info)) {
-			free(seg_info);
-			return false;
-		}
-
-		/* Advance. */
-		read_bytes -= page_read_bytes;
-		zero_bytes -= page_zero_bytes;
-		upage += PGSIZE;
-		now += PGSIZE;
-	}
-	return true;
+	/* segment 전체를 region 하나로 기술하고, page는 처음 접근할 때 만듦.
+	 * 파일은 running을 쓰므로 region에는 넘기지 않음 */
+	return vm_region_add (&thread_current ()->spt, upage, read_bytes + zero_bytes,
+			VM_SEG, writable, lazy_load_segment, NULL, ofs, read_bytes) != NULL;
 }
 
 /* Create a PAGE of stack at the USER_STACK. Return true on success. */
@@ -883,8 +870,7 @@ setup_stack (struct intr_frame *if_) {
 	/* TODO: Your code goes here */
 	vm_alloc_page(VM_STACK, stack_bottom, true);
 
-	success = vm_claim_page(stack_bottom);
-	memset(stack_bottom, 0, PGSIZE);
+	success = vm_claim_page(stack_bottom);		/* 0으로 채워진 frame을 받음 */
 
 	if_->rsp = USER_STACK;
 
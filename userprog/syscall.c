@@ -38,6 +38,11 @@ int exec (char *file_name);
 int dup2(int oldfd, int newfd);
 void *mmap (void *addr, size_t length, int writable, int fd, off_t offset);
 void munmap (void *addr);
+int madvise (void *addr, size_t length, int advice);
+int msync (void *addr, size_t length);
+void set_rss_limit (size_t pages);
+size_t get_rss (void);
+void *sbrk (intptr_t increment);
 
 /* syscall helper functions */
 void check_address(const uint64_t *uaddr);
@@ -139,6 +144,21 @@ syscall_handler (struct intr_frame *f UNUSED) {
 	case SYS_MUNMAP: /*** haein ***/
 		munmap(f->R.rdi);
 		break;
+	case SYS_MADVISE: /*** haein ***/
+		f->R.rax = madvise((void *) f->R.rdi, f->R.rsi, f->R.rdx);
+		break;
+	case SYS_MSYNC: /*** haein ***/
+		f->R.rax = msync((void *) f->R.rdi, f->R.rsi);
+		break;
+	case SYS_SET_RSS_LIMIT: /*** haein ***/
+		set_rss_limit(f->R.rdi);
+		break;
+	case SYS_GET_RSS: /*** haein ***/
+		f->R.rax = get_rss();
+		break;
+	case SYS_SBRK: /*** haein ***/
+		f->R.rax = (uint64_t) sbrk(f->R.rdi);
+		break;
 	case SYS_DUP2:
 		f->R.rax = dup2(f->R.rdi, f->R.rsi);
 		break;
@@ -311,7 +331,15 @@ int write(int fd, const void *buffer, unsigned size)
 	else
 	{
 		lock_acquire(&file_rw_lock);
+#ifdef VM
+		/* 같은 파일을 mmap한 frame에도 반영 */
+		off_t ofs = file_tell(fileobj);
+		ret = file_write(fileobj, buffer, size);
+		if (ret > 0)
+			vm_mapped_write(file_get_inode(fileobj), ofs, buffer, ret);
+#else
 		ret = file_write(fileobj, buffer, size);
+#endif
 		lock_release(&file_rw_lock);
 	}
 
@@ -367,7 +395,15 @@ int read(int fd, void *buffer, unsigned size)
 	}
 	else{
 		lock_acquire(&file_rw_lock);
+#ifdef VM
+		/* 아직 writeback되지 않은 mmap의 내용을 읽도록 */
+		off_t ofs = file_tell(fileobj);
 		ret = file_read(fileobj, buffer, size);
+		if (ret > 0)
+			vm_mapped_read(file_get_inode(fileobj), ofs, buffer, ret);
+#else
+		ret = file_read(fileobj, buffer, size);
+#endif
 		lock_release(&file_rw_lock);
 	}
 	return ret;
@@ -460,11 +496,18 @@ int dup2(int oldfd, int newfd){
 }
 
 /*** haein ***/
+/* FD가 -1이면 파일 없이 0으로 채워지는 익명 매핑을 만듦 (OFFSET은 무시) */
 void *mmap (void *addr, size_t length, int writable, int fd, off_t offset) {
+	if (addr != pg_round_down(addr) || addr == NULL || (int) length <= 0 || is_kernel_vaddr(addr)) {
+		return NULL;
+	}
+	if (fd == -1) {
+		return do_mmap_anon (addr, length, writable);
+	}
+
 	struct file *fileobj = find_file_by_fd(fd);
 
-	if (fileobj == NULL || file_length(fileobj) == 0 || addr != pg_round_down(addr) || addr == NULL 
-		|| (int) length <= 0 || fd == 0 || fd == 1 || is_kernel_vaddr(addr) || offset != pg_round_down(offset)) {
+	if (fileobj == NULL || file_length(fileobj) == 0 || fd == 0 || fd == 1 || offset != pg_round_down(offset)) {
 		return NULL;
 	}
 
@@ -477,3 +520,43 @@ void munmap (void *addr) {
 		do_munmap(addr);
 	}
 }
+
+/*** haein ***/
+/* 0 on success, -1 if the range is bad or has nothing mapped. */
+int madvise (void *addr, size_t length, int advice) {
+	if (addr != pg_round_down(addr) || addr == NULL || length == 0
+		|| (uint64_t) addr + length < (uint64_t) addr || !is_user_vaddr((uint64_t) addr + length - 1)
+		|| advice < VM_ADV_NORMAL || advice > VM_ADV_DONTNEED) {
+		return -1;
+	}
+
+	return vm_madvise(addr, length, advice) ? 0 : -1;
+}
+
+/*** haein ***/
+/* 0 on success, -1 if the range is bad or holds no file mapping. */
+int msync (void *addr, size_t length) {
+	if (addr != pg_round_down(addr) || addr == NULL || length == 0
+		|| (uint64_t) addr + length < (uint64_t) addr || !is_user_vaddr((uint64_t) addr + length - 1)) {
+		return -1;
+	}
+
+	return do_msync(addr, length) ? 0 : -1;
+}
+
+/*** haein ***/
+/* 0이면 제한을 풂. 한도는 fork한 자식과 exec한 프로그램에도 그대로 이어짐 */
+void set_rss_limit (size_t pages) {
+	vm_set_rss_limit(pages);
+}
+
+/*** haein ***/
+size_t get_rss (void) {
+	return thread_current()->rss;
+}
+
+/*** haein ***/
+/* 이전 break를 돌려줌. 늘릴 수 없거나 heap 시작보다 줄이려 하면 (void *) -1 */
+void *sbrk (intptr_t increment) {
+	return vm_sbrk(increment);
+}
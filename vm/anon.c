@@ -1,18 +1,102 @@
 /* anon.c: Implementation of page for non-disk image (a.k.a. anonymous page). */
 
 #include "vm/vm.h"
+#include "vm/rmap.h"
+#include "vm/zswap.h"
 #include "devices/disk.h"
 #include "bitmap.h"
 #include "threads/vaddr.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/malloc.h"
+#include "threads/palloc.h"
+#include <round.h>
+#include <string.h>
 
 #define PG_PER_SEC (PGSIZE/DISK_SECTOR_SIZE)
+#define SWAP_CACHE_SIZE 16		/* swap cache에 담을 수 있는 page 수 */
+#define SWAP_RA_MAX 8			/* readahead window의 최대 크기 */
+#define SLOTS_PER_GROUP 64		/* 빈 slot 수를 따로 세어 두는 묶음 크기 */
+#define SWAP_DEV_MAX 2			/* channel 1의 장치 2개, channel 0은 kernel과 filesys 차지 */
+#define SWAP_IO_BATCH 16		/* 한 번에 장치들로 나눠 보내거나 명령 하나로 묶는 page 수 */
 
 /* DO NOT MODIFY BELOW LINE */
-static struct disk *swap_disk;
+static struct disk *swap_disk;			/* 첫 번째 swap 장치 */
 static bool anon_swap_in (struct page *page, void *kva);
 static bool anon_swap_out (struct page *page);
 static void anon_destroy (struct page *page);
 static struct bitmap *swap_table;
+static struct lock swap_lock;			/* swap_table, slot_owner, swap cache 보호 */
+static uint64_t **slot_owner;			/* slot을 쓴 주소 공간(pml4), 쓰는 중이거나 빈 slot은 NULL */
+static unsigned *slot_refs;				/* slot을 가리키는 page 수, 공유 frame을 쓴 slot만 1보다 큼 */
+
+/* Slot allocator: 직전 할당 바로 뒤(cursor)부터 찾는 next-fit.
+ * group마다 빈 slot 수를 세어 두어 꽉 찬 group은 bit를 보지 않고 건너뜀 */
+static uint8_t *group_free;				/* group별 빈 slot 수 */
+static size_t group_cnt;
+static size_t swap_free_cnt;			/* 전체 빈 slot 수 */
+static size_t swap_cursor;				/* 다음 탐색을 시작할 slot */
+
+/* Swap cache: readahead로 미리 읽어 둔 slot들. 주인 page의 fault가
+ * 오면 disk를 거치지 않고 복사해 감. 읽기는 swap_lock 밖에서 하므로
+ * 그동안은 loading으로 표시해 두고 다른 readahead가 가져가지 못하게 함 */
+struct swap_cache_entry {
+	int slot;					/* 비어 있으면 -1 */
+	void *kva;					/* 내용을 담는 kernel page */
+	bool loading;				/* readahead가 아직 읽는 중 */
+};
+static struct swap_cache_entry swap_cache[SWAP_CACHE_SIZE];
+static size_t swap_cache_hand;			/* 다음에 교체할 entry */
+static size_t ra_window;				/* 현재 readahead window 크기 */
+static int last_fault_slot;				/* 직전에 disk에서 읽은 slot */
+
+/* Swap 장치들. slot s는 swap_devs[s % swap_dev_cnt]의 s / swap_dev_cnt 번째
+ * page에 있으므로 연속된 slot은 장치를 돌아가며 놓임. cluster나 readahead처럼
+ * 여러 slot을 한꺼번에 읽고 쓸 때는 장치마다 있는 worker thread에 나눠 줌.
+ * 표준 disk 배치에서는 channel 0이 kernel과 filesys로 차 있어서 쓸 수 있는
+ * 장치가 channel 1의 두 개뿐이고, 한 channel의 전송은 channel lock으로
+ * 줄을 서므로 두 장치를 묶어도 대역폭은 늘지 않고 용량만 늘어남 */
+struct swap_dev {
+	int chan_no, dev_no;
+	struct disk *disk;
+	struct list queue;					/* 처리할 swap_io */
+	struct lock queue_lock;
+	struct semaphore queue_sema;		/* queue에 든 요청 수 */
+};
+static struct swap_dev swap_devs[SWAP_DEV_MAX];
+static size_t swap_dev_cnt;				/* -swap= 로 정함, 기본은 hd1:1 하나 */
+
+/* put/get action이 scratch disk (hd1:0)를 쓰면 true. 그 disk는 swap으로 못 씀 */
+bool swap_scratch_busy;
+
+/* 장치가 하나일 때 이어진 slot들을 명령 한 번으로 옮기기 위한 buffer */
+static uint8_t *swap_bounce;			/* SWAP_IO_BATCH page */
+static struct lock swap_bounce_lock;
+
+/* swap 장치로 가는 page 하나의 I/O */
+struct swap_io {
+	size_t slot;
+	void *kva;
+	bool write;
+	struct semaphore *done;				/* 끝나면 up */
+	struct list_elem elem;				/* swap_dev의 queue */
+};
+
+static void swap_out_disk (struct page *page);
+static size_t swap_slot_alloc (size_t cnt);
+static void swap_slots_mark (size_t slot, size_t cnt, bool used);
+static void swap_write_pages (struct page *pages[], size_t cnt);
+static void swap_rw (size_t slot, void *kva, bool write);
+static void swap_io_batch (struct swap_io ios[], size_t cnt);
+static void swap_rw_run (struct swap_io ios[], size_t cnt);
+static void swap_worker (void *dev_);
+static void swap_slot_free (size_t slot);
+static struct swap_cache_entry *swap_cache_lookup (size_t slot);
+static void swap_cache_drop (struct swap_cache_entry *e, bool used);
+static size_t swap_readahead (size_t slot, uint64_t *pml4, struct swap_io ios[],
+		struct swap_cache_entry *entries[]);
+static void swap_readahead_done (struct swap_cache_entry *entries[], size_t cnt);
+static void anon_take_slot (struct page *page, void *slot_);
 
 /* DO NOT MODIFY this struct */
 static const struct page_operations anon_ops = {
@@ -27,9 +111,121 @@ static const struct page_operations anon_ops = {
 void
 vm_anon_init (void) {
 	/* TODO: Set up the swap_disk. */
-	swap_disk = disk_get(1,1);
-	size_t bit_cnt = disk_size(swap_disk) / PG_PER_SEC;
+	if (swap_dev_cnt == 0) {
+		swap_devs[0].chan_no = 1;
+		swap_devs[0].dev_no = 1;
+		swap_dev_cnt = 1;
+	}
+
+	/* 없는 장치는 빼고, 이웃한 slot이 가능하면 다른 channel에 놓이도록
+	 * (dev_no, chan_no) 순으로 늘어놓음 */
+	size_t n = 0;
+	for (size_t i = 0; i < swap_dev_cnt; i++) {
+		struct swap_dev dev = swap_devs[i];
+		dev.disk = disk_get(dev.chan_no, dev.dev_no);
+		if (dev.disk == NULL) {
+			continue;
+		}
+		/* swap이 덮어쓰면 -get으로 꺼내는 파일이 망가짐 */
+		if (dev.chan_no == 1 && dev.dev_no == 0 && swap_scratch_busy) {
+			PANIC("swap disk hd1:0 is the scratch disk used by put/get");
+		}
+		size_t j = n++;
+		for (; j > 0 && (swap_devs[j - 1].dev_no > dev.dev_no
+					|| (swap_devs[j - 1].dev_no == dev.dev_no && swap_devs[j - 1].chan_no > dev.chan_no)); j--) {
+			swap_devs[j] = swap_devs[j - 1];
+		}
+		swap_devs[j] = dev;
+	}
+	swap_dev_cnt = n;
+	if (swap_dev_cnt == 0) {
+		PANIC("no swap disk");
+	}
+	swap_disk = swap_devs[0].disk;
+
+	/* 모든 장치에 같은 수의 slot을 둠 */
+	size_t dev_slots = disk_size(swap_disk) / PG_PER_SEC;
+	for (size_t i = 1; i < swap_dev_cnt; i++) {
+		if (disk_size(swap_devs[i].disk) / PG_PER_SEC < dev_slots) {
+			dev_slots = disk_size(swap_devs[i].disk) / PG_PER_SEC;
+		}
+	}
+	if (swap_dev_cnt == 1) {
+		swap_bounce = palloc_get_multiple(PAL_ASSERT, SWAP_IO_BATCH);
+		lock_init(&swap_bounce_lock);
+	} else {
+		for (size_t i = 0; i < swap_dev_cnt; i++) {
+			list_init(&swap_devs[i].queue);
+			lock_init(&swap_devs[i].queue_lock);
+			sema_init(&swap_devs[i].queue_sema, 0);
+			thread_create("swapio", PRI_DEFAULT, swap_worker, &swap_devs[i]);
+		}
+	}
+
+	size_t bit_cnt = dev_slots * swap_dev_cnt;
 	swap_table = bitmap_create(bit_cnt);
+	slot_owner = calloc(bit_cnt, sizeof *slot_owner);
+	slot_refs = calloc(bit_cnt, sizeof *slot_refs);
+	lock_init(&swap_lock);
+
+	group_cnt = DIV_ROUND_UP(bit_cnt, SLOTS_PER_GROUP);
+	group_free = malloc(group_cnt);
+	for (size_t g = 0; g < group_cnt; g++) {
+		group_free[g] = g + 1 < group_cnt ? SLOTS_PER_GROUP : bit_cnt - g * SLOTS_PER_GROUP;
+	}
+	swap_free_cnt = bit_cnt;
+	swap_cursor = 0;
+
+	uint8_t *buf = palloc_get_multiple(PAL_ASSERT, SWAP_CACHE_SIZE);
+	for (size_t i = 0; i < SWAP_CACHE_SIZE; i++) {
+		swap_cache[i].slot = -1;
+		swap_cache[i].kva = buf + i * PGSIZE;
+		swap_cache[i].loading = false;
+	}
+	ra_window = SWAP_RA_MAX / 2;
+	last_fault_slot = -1;
+
+	zswap_init();
+}
+
+/*** haein ***/
+/* Parse the -swap= option: a comma-separated list of CHAN:DEV pairs,
+ * e.g. "1:1,1:0". Returns false if SPEC is malformed, names a disk twice
+ * or names a disk on channel 0, which holds the kernel (0:0) and the
+ * file system (0:1). hd1:0 is also the scratch disk; vm_anon_init
+ * refuses it when a put or get action needs that disk. */
+bool
+swap_set_disks (const char *spec) {
+	swap_dev_cnt = 0;
+	for (;;) {
+		if (swap_dev_cnt == SWAP_DEV_MAX
+				|| spec[0] < '0' || spec[0] > '1' || spec[1] != ':'
+				|| spec[2] < '0' || spec[2] > '1') {
+			return false;
+		}
+		int chan_no = spec[0] - '0';
+		int dev_no = spec[2] - '0';
+		/* swap으로 덮어쓰면 부팅 disk나 filesys_disk가 망가짐 */
+		if (chan_no == 0) {
+			return false;
+		}
+		for (size_t i = 0; i < swap_dev_cnt; i++) {
+			if (swap_devs[i].chan_no == chan_no && swap_devs[i].dev_no == dev_no) {
+				return false;
+			}
+		}
+		swap_devs[swap_dev_cnt].chan_no = chan_no;
+		swap_devs[swap_dev_cnt].dev_no = dev_no;
+		swap_dev_cnt++;
+
+		if (spec[3] == '\0') {
+			return true;
+		}
+		if (spec[3] != ',') {
+			return false;
+		}
+		spec += 4;
+	}
 }
 
 /*** haein ***/
@@ -43,11 +239,26 @@ anon_initializer (struct page *page, enum vm_type type, void *kva UNUSED) {
 
 	anon_page->aux_type = VM_AUXTYPE(type); // anon_page의 aux_type은 anon_type이므로 1을 빼줌
 	anon_page->slot_number = -1;            // 아직 swap out된 적 없으므로 slot number -1로 줌
+	anon_page->zswap_chunk = ZSWAP_NONE;
+	anon_page->zswap_len = 0;
 
 	/*** 고민 필요!!! (bool형 리턴값 false인 경우?) ***/
 	return true;
 }
 
+/*** haein ***/
+/* Do the anonymous mmap */
+/* 파일 없이 [ADDR, ADDR + LENGTH)를 region 하나로 기술함. page는 처음
+ * 접근할 때 0으로 채워진 anon page로 만들어지고 evict되면 swap으로 감 */
+void *
+do_mmap_anon (void *addr, size_t length, int writable) {
+	if (vm_region_add (&thread_current ()->spt, addr, length, VM_ANON, writable,
+				NULL, NULL, 0, 0) == NULL) {
+		return NULL;
+	}
+	return addr;
+}
+
 /*** haein ***/
 /* Swap in the page by read contents from the swap disk. */
 /* 프로세스가 swap out된 페이지에 접근하려고 하는 경우,
@@ -56,18 +267,48 @@ anon_initializer (struct page *page, enum vm_type type, void *kva UNUSED) {
 static bool
 anon_swap_in (struct page *page, void *kva) {
 	struct anon_page *anon_page = &page->anon;
+
+	/* 압축해서 RAM에 남겨 둔 page면 disk를 거치지 않음 */
+	if (anon_page->zswap_chunk != ZSWAP_NONE) {
+		zswap_load(anon_page, kva);
+		return true;
+	}
 	
 	int slot_number = anon_page->slot_number;
-	int sec_no = anon_page->slot_number * PG_PER_SEC;
-	void *_kva = page->frame->kva;
+	struct swap_io ios[1 + SWAP_RA_MAX];
+	struct swap_cache_entry *entries[SWAP_RA_MAX];
 
-	for (int i=0; i<PG_PER_SEC; i++) {
-		disk_read(swap_disk, sec_no, _kva);
-		_kva += DISK_SECTOR_SIZE;
-		sec_no++;
+	lock_acquire(&swap_lock);
+	struct swap_cache_entry *e = swap_cache_lookup(slot_number);
+	if (e != NULL && !e->loading) {
+		/* readahead가 맞았음: disk를 거치지 않음 */
+		memcpy(kva, e->kva, PGSIZE);
+		swap_cache_drop(e, true);
+		swap_slot_free(slot_number);
+		lock_release(&swap_lock);
+		anon_page->slot_number = -1;
+		return true;
 	}
-	
-	bitmap_set(swap_table, slot_number, false);
+
+	/* window가 0으로 줄었더라도 연속된 fault가 보이면 다시 열어 줌 */
+	if (ra_window == 0 && slot_number == last_fault_slot + 1) {
+		ra_window = 1;
+	}
+	last_fault_slot = slot_number;
+	size_t ra_cnt = swap_readahead(slot_number, page->frame->pml4, ios + 1, entries);
+	lock_release(&swap_lock);
+
+	/* 이 page의 slot은 아직 이 page가 잡고 있으므로 lock 없이 읽어도 됨.
+	 * 뒤따르는 slot들과 한 번에 보내면 장치가 하나일 때 명령 하나로 끝남 */
+	ios[0].slot = slot_number;
+	ios[0].kva = kva;
+	ios[0].write = false;
+	swap_io_batch(ios, 1 + ra_cnt);
+
+	lock_acquire(&swap_lock);
+	swap_readahead_done(entries, ra_cnt);
+	swap_slot_free(slot_number);
+	lock_release(&swap_lock);
 	anon_page->slot_number = -1;
 
 	return true;
@@ -80,30 +321,403 @@ static bool
 anon_swap_out (struct page *page) {
 	struct anon_page *anon_page = &page->anon;
 
-	anon_page->slot_number = bitmap_scan_and_flip(swap_table, 0, 1, false);
+	if (zswap_store(anon_page, page->frame->kva)) {
+		return true;
+	}
+	swap_out_disk(page);
+	return true;
+}
+
+/*** GrilledSalmon ***/
+/* Write PAGE to a free slot of the swap disk. */
+static void
+swap_out_disk (struct page *page) {
+	struct anon_page *anon_page = &page->anon;
+
+	lock_acquire(&swap_lock);
+	anon_page->slot_number = swap_slot_alloc(1);
+	lock_release(&swap_lock);
 	if (anon_page->slot_number == BITMAP_ERROR) {
 		PANIC("Ran Out of Swap Partition!!!");
 	}
 	
-	int sec_no = anon_page->slot_number * PG_PER_SEC;
-	void *kva = page->frame->kva;
+	swap_write_pages(&page, 1);
+}
 
-	for (int i=0; i<PG_PER_SEC; i++) {
-		disk_write(swap_disk, sec_no, kva);
-		kva += DISK_SECTOR_SIZE;
-		sec_no++;
+/*** haein ***/
+/* Swap out CNT anonymous pages at once. Pages that compress well stay in
+ * zswap; the slots of the rest are allocated as one contiguous run, so
+ * they are spread over all swap devices and written in parallel. Falls
+ * back to page-by-page allocation when no such run exists. */
+bool
+anon_swap_out_cluster (struct page *pages[], size_t cnt) {
+	struct page *batch[SWAP_IO_BATCH];
+	size_t batch_cnt = 0;
+	size_t spill = 0;
+
+	for (size_t i = 0; i < cnt; i++) {
+		if (!zswap_store(&pages[i]->anon, pages[i]->frame->kva)) {
+			spill++;
+		}
 	}
+	if (spill == 0) {
+		return true;
+	}
+
+	lock_acquire(&swap_lock);
+	size_t slot = swap_slot_alloc(spill);
+	lock_release(&swap_lock);
 
+	/* zswap에 들어가지 못한 page들만 disk로 */
+	for (size_t i = 0; i < cnt; i++) {
+		if (pages[i]->anon.zswap_chunk != ZSWAP_NONE) {
+			continue;
+		}
+		if (slot == BITMAP_ERROR) {
+			swap_out_disk(pages[i]);
+			continue;
+		}
+		pages[i]->anon.slot_number = slot++;
+		batch[batch_cnt++] = pages[i];
+		if (batch_cnt == SWAP_IO_BATCH) {
+			swap_write_pages(batch, batch_cnt);
+			batch_cnt = 0;
+		}
+	}
+	if (batch_cnt > 0) {
+		swap_write_pages(batch, batch_cnt);
+	}
 	return true;
 }
 
+/*** haein ***/
+/* Swap out FRAME, shared by the anonymous pages that map it (after fork
+ * or as shared text). The contents are written once to a single slot
+ * that every one of those pages points to; each swap-in drops one
+ * reference to it. zswap is skipped because its entries belong to one
+ * page. Called without frame_lock, while FRAME is marked as under
+ * writeback so its mappings stay put. */
+void
+anon_swap_out_shared (struct frame *frame) {
+	lock_acquire(&swap_lock);
+	size_t slot = swap_slot_alloc(1);
+	if (slot != BITMAP_ERROR) {
+		slot_refs[slot] = rmap_count(frame);
+	}
+	lock_release(&swap_lock);
+	if (slot == BITMAP_ERROR) {
+		PANIC("Ran Out of Swap Partition!!!");
+	}
+
+	/* 주인이 여럿이므로 slot_owner는 NULL로 두어 readahead가 건너뛰게 함 */
+	swap_rw(slot, frame->kva, true);
+	rmap_apply(frame, anon_take_slot, &slot);
+}
+
+/*** haein ***/
+/* rmap_apply() action: PAGE now lives in swap slot *SLOT_. */
+static void
+anon_take_slot (struct page *page, void *slot_) {
+	page->anon.slot_number = *(size_t *) slot_;
+}
+
+/*** haein ***/
+/* Write the frames of the CNT pages in PAGES (at most SWAP_IO_BATCH) into
+ * the swap slots they were given. The slots become visible to readahead
+ * only once the writes are done. */
+static void
+swap_write_pages (struct page *pages[], size_t cnt) {
+	struct swap_io ios[SWAP_IO_BATCH];
+
+	ASSERT (cnt <= SWAP_IO_BATCH);
+	for (size_t i = 0; i < cnt; i++) {
+		ios[i].slot = pages[i]->anon.slot_number;
+		ios[i].kva = pages[i]->frame->kva;
+		ios[i].write = true;
+	}
+	swap_io_batch(ios, cnt);
+
+	lock_acquire(&swap_lock);
+	for (size_t i = 0; i < cnt; i++) {
+		slot_owner[ios[i].slot] = pages[i]->frame->pml4;
+	}
+	lock_release(&swap_lock);
+}
+
+/*** haein ***/
+/* Read or write the page in swap slot SLOT with one multi-sector command
+ * on the device that holds it. */
+static void
+swap_rw (size_t slot, void *kva, bool write) {
+	struct disk *disk = swap_devs[slot % swap_dev_cnt].disk;
+	disk_sector_t sec_no = slot / swap_dev_cnt * PG_PER_SEC;
+
+	if (write) {
+		disk_write_multiple(disk, sec_no, kva, PG_PER_SEC);
+	} else {
+		disk_read_multiple(disk, sec_no, kva, PG_PER_SEC);
+	}
+}
+
+/*** haein ***/
+/* Carry out the CNT requests in IOS and return once all of them are done.
+ * With one swap device, requests for consecutive slots in the same
+ * direction are sent as one multi-sector command. With several swap
+ * devices each request is handed to the worker of its device, so devices
+ * on different channels transfer at the same time. */
+static void
+swap_io_batch (struct swap_io ios[], size_t cnt) {
+	if (swap_dev_cnt == 1) {
+		for (size_t i = 0; i < cnt; ) {
+			size_t run = 1;
+
+			while (i + run < cnt && run < SWAP_IO_BATCH
+					&& ios[i + run].slot == ios[i].slot + run
+					&& ios[i + run].write == ios[i].write) {
+				run++;
+			}
+			swap_rw_run(&ios[i], run);
+			i += run;
+		}
+		return;
+	}
+	if (cnt == 1) {
+		swap_rw(ios[0].slot, ios[0].kva, ios[0].write);
+		return;
+	}
+
+	struct semaphore done;
+	sema_init(&done, 0);
+	for (size_t i = 0; i < cnt; i++) {
+		struct swap_dev *dev = &swap_devs[ios[i].slot % swap_dev_cnt];
+
+		ios[i].done = &done;
+		lock_acquire(&dev->queue_lock);
+		list_push_back(&dev->queue, &ios[i].elem);
+		lock_release(&dev->queue_lock);
+		sema_up(&dev->queue_sema);
+	}
+	for (size_t i = 0; i < cnt; i++) {
+		sema_down(&done);
+	}
+}
+
+/*** haein ***/
+/* Carry out the CNT requests in IOS, for consecutive slots of the only
+ * swap device and all in the same direction, as one multi-sector command
+ * through swap_bounce. The frames are not contiguous in memory, so each
+ * page is copied to or from the bounce buffer. */
+static void
+swap_rw_run (struct swap_io ios[], size_t cnt) {
+	ASSERT (swap_dev_cnt == 1 && cnt <= SWAP_IO_BATCH);
+
+	if (cnt == 1) {
+		swap_rw(ios[0].slot, ios[0].kva, ios[0].write);
+		return;
+	}
+
+	struct disk *disk = swap_devs[0].disk;
+	disk_sector_t sec_no = ios[0].slot * PG_PER_SEC;
+
+	lock_acquire(&swap_bounce_lock);
+	if (ios[0].write) {
+		for (size_t i = 0; i < cnt; i++) {
+			memcpy(swap_bounce + i * PGSIZE, ios[i].kva, PGSIZE);
+		}
+		disk_write_multiple(disk, sec_no, swap_bounce, cnt * PG_PER_SEC);
+	} else {
+		disk_read_multiple(disk, sec_no, swap_bounce, cnt * PG_PER_SEC);
+		for (size_t i = 0; i < cnt; i++) {
+			memcpy(ios[i].kva, swap_bounce + i * PGSIZE, PGSIZE);
+		}
+	}
+	lock_release(&swap_bounce_lock);
+}
+
+/*** haein ***/
+/* Worker thread of one swap device: performs its queued requests in
+ * order. */
+static void
+swap_worker (void *dev_) {
+	struct swap_dev *dev = dev_;
+
+	for (;;) {
+		sema_down(&dev->queue_sema);
+		lock_acquire(&dev->queue_lock);
+		struct swap_io *io = list_entry(list_pop_front(&dev->queue), struct swap_io, elem);
+		lock_release(&dev->queue_lock);
+
+		swap_rw(io->slot, io->kva, io->write);
+		sema_up(io->done);
+	}
+}
+
+/*** haein ***/
+/* Drop one reference to SLOT and release it once no page points to it.
+ * A cache entry still holding it was never used. Must hold swap_lock. */
+static void
+swap_slot_free (size_t slot) {
+	if (--slot_refs[slot] > 0) {
+		return;
+	}
+
+	struct swap_cache_entry *e = swap_cache_lookup(slot);
+
+	if (e != NULL) {
+		swap_cache_drop(e, false);
+	}
+	slot_owner[slot] = NULL;
+	swap_slots_mark(slot, 1, false);
+}
+
+/*** haein ***/
+/* Allocate CNT contiguous free slots, looking from just after the last
+ * allocation and wrapping around once. Full groups are skipped without
+ * touching their bits, so the cost does not grow with the used part of
+ * the swap disk. Returns the first slot, or BITMAP_ERROR.
+ * Must hold swap_lock. */
+static size_t
+swap_slot_alloc (size_t cnt) {
+	size_t slot_cnt = bitmap_size(swap_table);
+
+	if (cnt == 0 || swap_free_cnt < cnt) {
+		return BITMAP_ERROR;
+	}
+
+	size_t g = swap_cursor / SLOTS_PER_GROUP;
+	for (size_t visited = 0; visited <= group_cnt; visited++, g = (g + 1) % group_cnt) {
+		if (group_free[g] == 0) {
+			continue;
+		}
+		size_t first = g * SLOTS_PER_GROUP;
+		size_t last = first + SLOTS_PER_GROUP;
+
+		/* 처음 보는 group은 cursor 위치부터, 한 바퀴 돌아온 뒤에는 처음부터 */
+		size_t start = visited == 0 ? swap_cursor : first;
+		if (last > slot_cnt) {
+			last = slot_cnt;
+		}
+
+		/* run은 다음 group으로 넘어가도 됨 */
+		for (size_t s = start; s < last && s + cnt <= slot_cnt; s++) {
+			if (bitmap_none(swap_table, s, cnt)) {
+				swap_slots_mark(s, cnt, true);
+				swap_cursor = (s + cnt) % slot_cnt;
+				return s;
+			}
+		}
+	}
+	return BITMAP_ERROR;
+}
+
+/*** haein ***/
+/* Mark CNT slots from SLOT as USED or free, keeping the counts in step.
+ * Must hold swap_lock. */
+static void
+swap_slots_mark (size_t slot, size_t cnt, bool used) {
+	bitmap_set_multiple(swap_table, slot, cnt, used);
+	for (size_t s = slot; s < slot + cnt; s++) {
+		if (used) {
+			group_free[s / SLOTS_PER_GROUP]--;
+			slot_refs[s] = 1;
+		} else {
+			group_free[s / SLOTS_PER_GROUP]++;
+		}
+	}
+	swap_free_cnt = used ? swap_free_cnt - cnt : swap_free_cnt + cnt;
+}
+
+/*** haein ***/
+/* Returns the swap cache entry holding SLOT, or NULL. */
+static struct swap_cache_entry *
+swap_cache_lookup (size_t slot) {
+	for (size_t i = 0; i < SWAP_CACHE_SIZE; i++) {
+		if (swap_cache[i].slot == (int) slot) {
+			return &swap_cache[i];
+		}
+	}
+	return NULL;
+}
+
+/*** haein ***/
+/* Empty entry E. USED tells whether its page was consumed by a fault;
+ * hits widen the readahead window and wasted reads halve it. */
+static void
+swap_cache_drop (struct swap_cache_entry *e, bool used) {
+	if (used) {
+		if (ra_window < SWAP_RA_MAX) {
+			ra_window++;
+		}
+	} else {
+		ra_window /= 2;
+	}
+	e->slot = -1;
+}
+
+/*** haein ***/
+/* Reserve swap cache entries for up to ra_window slots following SLOT,
+ * stopping at the first slot that is free or owned by another address
+ * space, and fill IOS and ENTRIES with the reads that bring them in.
+ * The caller does the reads without swap_lock, then calls
+ * swap_readahead_done(). Returns the number of reads. Must hold
+ * swap_lock. */
+static size_t
+swap_readahead (size_t slot, uint64_t *pml4, struct swap_io ios[],
+		struct swap_cache_entry *entries[]) {
+	size_t window = ra_window;
+	size_t cnt = 0;
+
+	for (size_t s = slot + 1; s <= slot + window && s < bitmap_size(swap_table); s++) {
+		if (!bitmap_test(swap_table, s) || slot_owner[s] != pml4) {
+			break;
+		}
+		if (swap_cache_lookup(s) != NULL) {
+			continue;
+		}
+
+		/* 다른 thread가 아직 읽고 있는 entry는 buffer를 덮어쓸 수 없음 */
+		struct swap_cache_entry *e = &swap_cache[swap_cache_hand];
+		if (e->loading) {
+			break;
+		}
+		swap_cache_hand = (swap_cache_hand + 1) % SWAP_CACHE_SIZE;
+		if (e->slot != -1) {
+			swap_cache_drop(e, false);
+		}
+		e->slot = s;
+		e->loading = true;
+
+		ios[cnt].slot = s;
+		ios[cnt].kva = e->kva;
+		ios[cnt].write = false;
+		entries[cnt++] = e;
+	}
+	return cnt;
+}
+
+/*** haein ***/
+/* The reads reserved for the CNT ENTRIES by swap_readahead() are done.
+ * An entry whose slot was freed in the meantime was already emptied by
+ * swap_slot_free(), so its contents are never used. Must hold swap_lock. */
+static void
+swap_readahead_done (struct swap_cache_entry *entries[], size_t cnt) {
+	for (size_t i = 0; i < cnt; i++) {
+		entries[i]->loading = false;
+	}
+}
+
 /*** Dongdongbro ***/
 /* Destroy the anonymous page. PAGE will be freed by the caller. */
 static void
 anon_destroy (struct page *page) {
 	struct anon_page *anon_page = &page->anon;
+
+	/* evict 도중이었다면 slot이 새로 생길 수 있으므로 frame 먼저 정리 */
+	vm_free_frame(page);
+	zswap_free(anon_page);
 	if(anon_page->slot_number != -1){
-		bitmap_set(swap_table, anon_page->slot_number, 0);
+		lock_acquire(&swap_lock);
+		swap_slot_free(anon_page->slot_number);
+		lock_release(&swap_lock);
 	}
-	free(page->frame);
 }
@@ -0,0 +1,487 @@
+/* evict.c: Page replacement policies for the frame table. */
+
+#include "vm/evict.h"
+#include "vm/rmap.h"
+#include "vm/vm.h"
+#include <hash.h>
+#include <list.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/mmu.h"
+#include "threads/slab.h"
+
+/* vm_get_victim이 쓰는 교체 정책. 부팅 때 -evict=NAME 으로 고름.
+ *   clock: frame table 전체를 도는 second chance (기본값)
+ *   2q:    처음 들어온 page는 FIFO(A1in)에 두고, 다시 쓰인 page만 clock(Am)으로 올림.
+ *          A1in에서 쫓겨난 page는 ghost(A1out)로 기억해 두었다가 돌아오면 바로 Am으로
+ *   arc:   ARC를 accessed bit로 구현한 CAR. 최근(T1)/자주(T2) 두 clock의 크기를
+ *          ghost(B1, B2) hit에 따라 조절함
+ * 모든 함수는 frame_lock을 잡은 상태에서 불림 */
+
+/* frame->lru_list 값 */
+enum lru_id {
+	LRU_NONE,
+	LRU_T1,			/* 2q의 A1in, arc의 T1 */
+	LRU_T2,			/* 2q의 Am, arc의 T2 */
+};
+
+/* 쫓겨난 page를 (pml4, va)로 기억해 두는 항목 */
+struct ghost {
+	uint64_t *pml4;
+	const void *va;
+	enum lru_id list;			/* LRU_T1이면 B1(A1out), LRU_T2이면 B2 */
+	struct list_elem elem;
+	struct hash_elem hash_elem;
+};
+
+#define TWOQ_IN_PCT 25			/* A1in이 차지할 frame 비율 */
+#define TWOQ_OUT_PCT 50			/* A1out에 기억할 ghost 수 (frame 대비) */
+
+static struct frame *frame_table;
+static size_t frame_cnt;
+
+static struct list t1, t2;				/* 상주 frame */
+static size_t t1_cnt, t2_cnt;
+static struct list b1, b2;				/* ghost, 앞쪽이 오래된 것 */
+static size_t b1_cnt, b2_cnt;
+static struct hash ghost_table;
+static struct slab_cache ghost_slab;
+static size_t arc_p;					/* arc: T1의 목표 크기 */
+static size_t clock_hand;				/* clock: 다음에 검사할 frame의 index */
+
+/* 통계 */
+static long long page_in_cnt;			/* frame을 새로 채운 user page fault */
+static long long refault_cnt;			/* 그 중 evict됐다가 돌아온 page */
+static long long evict_cnt;
+static long long ghost_hit_cnt;
+
+static void clock_init (void);
+static struct frame *clock_select (void);
+static void twoq_insert (struct frame *);
+static struct frame *twoq_select (void);
+static void arc_insert (struct frame *);
+static struct frame *arc_select (void);
+static void lru_remove (struct frame *);
+
+static const struct evict_policy policies[] = {
+	{ "clock", clock_init, NULL, NULL, clock_select },
+	{ "2q", NULL, twoq_insert, lru_remove, twoq_select },
+	{ "arc", NULL, arc_insert, lru_remove, arc_select },
+};
+static const struct evict_policy *policy = &policies[0];
+
+/*** haein ***/
+/* Choose the policy called NAME. Returns false if there is none. Must be
+ * called before evict_init(). */
+bool
+evict_policy_set (const char *name) {
+	for (size_t i = 0; i < sizeof policies / sizeof *policies; i++) {
+		if (!strcmp (name, policies[i].name)) {
+			policy = &policies[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+/*** haein ***/
+static uint64_t
+ghost_hash (const struct hash_elem *e, void *aux UNUSED) {
+	const struct ghost *g = hash_entry (e, struct ghost, hash_elem);
+	return hash_bytes (&g->pml4, sizeof g->pml4) ^ hash_bytes (&g->va, sizeof g->va);
+}
+
+/*** haein ***/
+static bool
+ghost_less (const struct hash_elem *a_, const struct hash_elem *b_, void *aux UNUSED) {
+	const struct ghost *a = hash_entry (a_, struct ghost, hash_elem);
+	const struct ghost *b = hash_entry (b_, struct ghost, hash_elem);
+
+	if (a->pml4 != b->pml4) {
+		return a->pml4 < b->pml4;
+	}
+	return a->va < b->va;
+}
+
+/*** haein ***/
+/* Set up the policy for the SIZE frames of TABLE. */
+void
+evict_init (struct frame *table, size_t size) {
+	frame_table = table;
+	frame_cnt = size;
+
+	list_init (&t1);
+	list_init (&t2);
+	list_init (&b1);
+	list_init (&b2);
+	hash_init (&ghost_table, ghost_hash, ghost_less, NULL);
+	slab_cache_init (&ghost_slab, "ghost", sizeof (struct ghost), NULL);
+
+	if (policy->init != NULL) {
+		policy->init ();
+	}
+}
+
+/*** haein ***/
+/* FRAME now holds a page and may be chosen as a victim. */
+void
+evict_insert (struct frame *frame) {
+	if (policy->insert != NULL) {
+		policy->insert (frame);
+	}
+}
+
+/*** haein ***/
+/* FRAME goes back to the user pool or is being evicted. */
+void
+evict_remove (struct frame *frame) {
+	if (policy->remove != NULL) {
+		policy->remove (frame);
+	}
+}
+
+/*** haein ***/
+/* Returns the frame to evict, or NULL if nothing can be evicted. */
+struct frame *
+evict_select (void) {
+	struct frame *victim = policy->select ();
+
+	if (victim != NULL) {
+		evict_cnt++;
+	}
+	return victim;
+}
+
+/*** haein ***/
+/* Count a user page fault that needed a frame. REFAULT tells whether the
+ * page had been loaded before and was evicted since. */
+void
+evict_note_fault (bool refault) {
+	page_in_cnt++;
+	if (refault) {
+		refault_cnt++;
+	}
+}
+
+/*** haein ***/
+/* Print the replacement statistics. */
+void
+evict_print_stats (void) {
+	printf ("Evict: %s policy, %lld page-ins, %lld refaults, %lld evictions, %lld ghost hits\n",
+			policy->name, page_in_cnt, refault_cnt, evict_cnt, ghost_hit_cnt);
+}
+
+/*** haein ***/
+/* Returns true if FRAME holds a page, or pages shared through rmap, that
+ * may be evicted right now. */
+static bool
+frame_evictable (struct frame *frame) {
+	/* 비어 있거나 아직 로딩 중인 frame은 주인도 매핑도 없음 */
+	return frame->pin_cnt == 0
+		&& (frame->page != NULL || !list_empty (&frame->mappings));
+}
+
+/*** haein ***/
+/* Returns whether FRAME was accessed since the last check, and clears
+ * the bit. */
+static bool
+frame_referenced (struct frame *frame) {
+	if (frame->pml4 == NULL) {
+		/* page cache처럼 매핑 없이 kernel이 쓰는 frame */
+		bool accessed = frame->accessed;
+		frame->accessed = false;
+		return accessed;
+	}
+	return rmap_test_and_clear_accessed (frame);
+}
+
+/* ---------------------------- clock ---------------------------- */
+
+/*** haein ***/
+static void
+clock_init (void) {
+	clock_hand = 0;
+}
+
+/*** GrilledSalmon & haein ***/
+/* Clock 알고리즘: hand는 호출 사이에 유지되고, 지나간 frame의 accessed bit을 지움.
+ * 두 바퀴 안에 accessed bit가 0인 frame을 반드시 만나므로 비용이 O(frames)로 제한됨. */
+static struct frame *
+clock_select (void) {
+	for (size_t scanned = 0; scanned < 2 * frame_cnt; scanned++) {
+		struct frame *frame = &frame_table[clock_hand];
+
+		if (++clock_hand == frame_cnt) {
+			clock_hand = 0;
+		}
+
+		if (frame_evictable (frame) && !frame_referenced (frame)) {
+			return frame;
+		}
+	}
+
+	/* 사용 중인 모든 frame이 pin 되어 있는 경우 */
+	return NULL;
+}
+
+/* ------------------------ resident lists ------------------------ */
+
+/*** haein ***/
+/* Append FRAME to list ID as a page that has not been looked at yet.
+ * The access that faulted it in sets its accessed bit, so the first
+ * visit of the hand only clears the bit instead of counting it as reuse. */
+static void
+lru_push (struct frame *frame, enum lru_id id) {
+	list_push_back (id == LRU_T1 ? &t1 : &t2, &frame->lru_elem);
+	*(id == LRU_T1 ? &t1_cnt : &t2_cnt) += 1;
+	frame->lru_list = id;
+	frame->lru_new = true;
+}
+
+/*** haein ***/
+/* Take FRAME off its list, if it is on one. */
+static void
+lru_remove (struct frame *frame) {
+	if (frame->lru_list == LRU_NONE) {
+		return;
+	}
+	list_remove (&frame->lru_elem);
+	*(frame->lru_list == LRU_T1 ? &t1_cnt : &t2_cnt) -= 1;
+	frame->lru_list = LRU_NONE;
+}
+
+/*** haein ***/
+/* Move FRAME to the back of list ID without touching its state. */
+static void
+lru_rotate (struct frame *frame, enum lru_id id) {
+	bool was_new = frame->lru_new;
+
+	lru_remove (frame);
+	lru_push (frame, id);
+	frame->lru_new = was_new;
+}
+
+/* ---------------------------- ghosts ---------------------------- */
+
+/*** haein ***/
+/* Fill *PML4 and *VA with the identity of FRAME's page. */
+static void
+ghost_key (struct frame *frame, uint64_t **pml4, const void **va) {
+	*pml4 = frame->pml4;
+	/* kernel이 쓰는 page는 주소가 없으므로 struct page로 구분 */
+	*va = frame->pml4 != NULL ? frame->page->va : (const void *) frame->page;
+}
+
+/*** haein ***/
+/* Returns the ghost of FRAME's page, or NULL. */
+static struct ghost *
+ghost_find (struct frame *frame) {
+	struct ghost key;
+	struct hash_elem *e;
+
+	/* 공유 frame은 page 하나로 정할 수 없으므로 ghost를 남기지 않음 */
+	if (frame->page == NULL) {
+		return NULL;
+	}
+	ghost_key (frame, &key.pml4, &key.va);
+	e = hash_find (&ghost_table, &key.hash_elem);
+	return e != NULL ? hash_entry (e, struct ghost, hash_elem) : NULL;
+}
+
+/*** haein ***/
+static void
+ghost_drop (struct ghost *g) {
+	hash_delete (&ghost_table, &g->hash_elem);
+	list_remove (&g->elem);
+	*(g->list == LRU_T1 ? &b1_cnt : &b2_cnt) -= 1;
+	slab_free (&ghost_slab, g);
+}
+
+/*** haein ***/
+/* Forget the oldest ghost of list ID, if any. */
+static void
+ghost_drop_oldest (enum lru_id id) {
+	struct list *l = id == LRU_T1 ? &b1 : &b2;
+
+	if (!list_empty (l)) {
+		ghost_drop (list_entry (list_front (l), struct ghost, elem));
+	}
+}
+
+/*** haein ***/
+/* Remember the page of FRAME, which is being evicted, in ghost list ID.
+ * Ghosts are only a hint, so running out of memory just skips it. */
+static void
+ghost_add (struct frame *frame, enum lru_id id) {
+	if (frame->page == NULL) {
+		return;
+	}
+
+	struct ghost *g = slab_alloc (&ghost_slab);
+	if (g == NULL) {
+		return;
+	}
+	ghost_key (frame, &g->pml4, &g->va);
+	g->list = id;
+
+	/* 같은 page의 ghost가 남아 있으면 새 것으로 바꿈 */
+	struct hash_elem *old = hash_replace (&ghost_table, &g->hash_elem);
+	if (old != NULL) {
+		struct ghost *o = hash_entry (old, struct ghost, hash_elem);
+		list_remove (&o->elem);
+		*(o->list == LRU_T1 ? &b1_cnt : &b2_cnt) -= 1;
+		slab_free (&ghost_slab, o);
+	}
+	list_push_back (id == LRU_T1 ? &b1 : &b2, &g->elem);
+	*(id == LRU_T1 ? &b1_cnt : &b2_cnt) += 1;
+}
+
+/*** haein ***/
+/* Forget every ghost of the address space PML4, which is going away.
+ * A later process may get the same pml4 page, and its first faults must
+ * not count as refaults of the old process's pages. */
+void
+evict_forget (uint64_t *pml4) {
+	struct list *lists[] = { &b1, &b2 };
+
+	for (size_t i = 0; i < sizeof lists / sizeof *lists; i++) {
+		struct list_elem *e = list_begin (lists[i]);
+		while (e != list_end (lists[i])) {
+			struct ghost *g = list_entry (e, struct ghost, elem);
+			e = list_next (e);
+			if (g->pml4 == pml4) {
+				ghost_drop (g);
+			}
+		}
+	}
+}
+
+/* ------------------------------ 2q ------------------------------ */
+
+/*** haein ***/
+static void
+twoq_insert (struct frame *frame) {
+	struct ghost *g = ghost_find (frame);
+
+	/* A1out에 있던 page는 다시 쓰인 것이므로 바로 Am으로 */
+	if (g != NULL) {
+		ghost_drop (g);
+		ghost_hit_cnt++;
+		lru_push (frame, LRU_T2);
+	} else {
+		lru_push (frame, LRU_T1);
+	}
+}
+
+/*** haein ***/
+/* Evict from the A1in FIFO while it is over its share, otherwise run a
+ * clock over Am. A page referenced while in A1in is promoted to Am. */
+static struct frame *
+twoq_select (void) {
+	size_t kin = frame_cnt * TWOQ_IN_PCT / 100 + 1;
+	size_t kout = frame_cnt * TWOQ_OUT_PCT / 100 + 1;
+	size_t limit = 4 * (t1_cnt + t2_cnt) + 4;
+
+	for (size_t steps = 0; steps < limit && t1_cnt + t2_cnt > 0; steps++) {
+		bool use_t1 = t1_cnt > 0 && (t1_cnt > kin || t2_cnt == 0);
+		enum lru_id id = use_t1 ? LRU_T1 : LRU_T2;
+		struct frame *frame = list_entry (list_front (use_t1 ? &t1 : &t2), struct frame, lru_elem);
+
+		if (!frame_evictable (frame)) {
+			lru_rotate (frame, id);
+			continue;
+		}
+		bool ref = frame_referenced (frame);
+		if (frame->lru_new) {
+			frame->lru_new = false;
+			lru_rotate (frame, id);
+			continue;
+		}
+
+		if (ref) {
+			lru_remove (frame);
+			lru_push (frame, LRU_T2);
+			frame->lru_new = false;
+			continue;
+		}
+		if (use_t1) {
+			ghost_add (frame, LRU_T1);
+			if (b1_cnt > kout) {
+				ghost_drop_oldest (LRU_T1);
+			}
+		}
+		return frame;
+	}
+	return NULL;
+}
+
+/* ------------------------------ arc ----------------------------- */
+
+/*** haein ***/
+static void
+arc_insert (struct frame *frame) {
+	struct ghost *g = ghost_find (frame);
+
+	if (g == NULL) {
+		/* ghost 공간 정리: T1 + B1 <= c, 전체 <= 2c */
+		if (t1_cnt + b1_cnt >= frame_cnt && b1_cnt > 0) {
+			ghost_drop_oldest (LRU_T1);
+		} else if (t1_cnt + t2_cnt + b1_cnt + b2_cnt >= 2 * frame_cnt && b2_cnt > 0) {
+			ghost_drop_oldest (LRU_T2);
+		}
+		lru_push (frame, LRU_T1);
+		return;
+	}
+
+	/* 최근에 쫓아낸 page가 돌아왔으면 그쪽 list를 키움 */
+	ghost_hit_cnt++;
+	if (g->list == LRU_T1) {
+		size_t delta = b1_cnt >= b2_cnt ? 1 : b2_cnt / b1_cnt;
+		arc_p = arc_p + delta < frame_cnt ? arc_p + delta : frame_cnt;
+	} else {
+		size_t delta = b2_cnt >= b1_cnt ? 1 : b1_cnt / b2_cnt;
+		arc_p = arc_p > delta ? arc_p - delta : 0;
+	}
+	ghost_drop (g);
+	lru_push (frame, LRU_T2);
+}
+
+/*** haein ***/
+/* CAR: sweep T1 while it is above its target size arc_p, else T2. A
+ * referenced T1 page moves to T2, a referenced T2 page gets a second
+ * chance, and an unreferenced one is evicted and remembered in B1 or B2. */
+static struct frame *
+arc_select (void) {
+	size_t limit = 4 * (t1_cnt + t2_cnt) + 4;
+
+	for (size_t steps = 0; steps < limit && t1_cnt + t2_cnt > 0; steps++) {
+		bool use_t1 = t1_cnt > 0 && (t1_cnt >= (arc_p > 0 ? arc_p : 1) || t2_cnt == 0);
+		enum lru_id id = use_t1 ? LRU_T1 : LRU_T2;
+		struct frame *frame = list_entry (list_front (use_t1 ? &t1 : &t2), struct frame, lru_elem);
+
+		if (!frame_evictable (frame)) {
+			lru_rotate (frame, id);
+			continue;
+		}
+		bool ref = frame_referenced (frame);
+		if (frame->lru_new) {
+			frame->lru_new = false;
+			lru_rotate (frame, id);
+			continue;
+		}
+
+		if (ref) {
+			lru_remove (frame);
+			lru_push (frame, LRU_T2);
+			frame->lru_new = false;
+			continue;
+		}
+		ghost_add (frame, id);
+		/* ghost 수는 frame 수를 넘지 않게 함 */
+		if (b1_cnt + b2_cnt > frame_cnt) {
+			ghost_drop_oldest (b1_cnt > b2_cnt ? LRU_T1 : LRU_T2);
+		}
+		return frame;
+	}
+	return NULL;
+}
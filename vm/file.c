@@ -1,14 +1,22 @@
 /* file.c: Implementation of memory backed file object (mmaped object). */
 
 #include "vm/vm.h"
+#include "vm/rmap.h"
+#include "filesys/inode.h"
 #include "threads/vaddr.h"
 #include "threads/malloc.h"
 #include "threads/mmu.h"
+#include "threads/palloc.h"
+#include <round.h>
+#include <string.h>
+
+#define WRITEBACK_BATCH 16		/* 한 번의 file_write_at으로 묶어 쓸 최대 page 수 */
 
 static bool file_backed_swap_in (struct page *page, void *kva);
 static bool file_backed_swap_out (struct page *page);
 static void file_backed_destroy (struct page *page);
 static bool lazy_load_file (struct page *page, void *aux);
+static void writeback_flush (struct file *file, const void *buf, size_t *bytes, off_t ofs);
 
 /* DO NOT MODIFY this struct */
 static const struct page_operations file_ops = {
@@ -35,7 +43,7 @@ file_backed_initializer (struct page *page, enum vm_type type, void *kva) {
 	file_page->file = lazy_info->file;
 	file_page->ofs = lazy_info->ofs;
 	file_page->read_bytes = lazy_info->read_bytes;
-	file_page->remain_cnt = lazy_info->remain_cnt;
+	file_page->region = lazy_info->region;
 
 	return true;
 }
@@ -61,115 +69,164 @@ file_backed_swap_in (struct page *page, void *kva) {
 static bool
 file_backed_swap_out (struct page *page) {
 	struct file_page *file_page = &page->file;
-	uint64_t current_pml4 = page->frame->pml4;
 
-	if(pml4_is_dirty(current_pml4, page->va)){
-		file_write_at(file_page->file, page->va, file_page->read_bytes, file_page->ofs);
-		pml4_set_dirty(current_pml4, page->va, false);
+	/* victim은 다른 프로세스의 page일 수 있으므로 user va가 아닌 kva로 씀.
+	 * 여러 프로세스가 나눠 쓰던 frame이면 누가 썼든 한 번만 씀.
+	 * writeback thread에서 불리므로 page cache에 frame을 새로 얻지 않는 길로 씀 */
+	if(rmap_is_dirty(page->frame)){
+		inode_write_back(file_get_inode(file_page->file), page->frame->kva,
+				file_page->read_bytes, file_page->ofs);
 	}
 	return true;
 }
 
 /*** Dongdongbro ***/
-/* Destory the file backed page. PAGE will be freed by the caller. */
+/* Destory the file backed page. PAGE will be freed by the caller.
+ * 파일은 region이 소유하므로 여기서 닫지 않음 */
 static void
 file_backed_destroy (struct page *page) {
-	struct file_page *file_page UNUSED = &page->file;
+	struct file_page *file_page = &page->file;
 	uint64_t current_pml4 = thread_current()->pml4;
 
-	if(pml4_get_page(current_pml4, page->va)){
+	/* writeback thread가 쓰는 중이면 끝나길 기다림, 그 뒤에는 frame이 없음 */
+	vm_wait_writeback(page);
+	if(page->frame != NULL){
 		if(pml4_is_dirty(current_pml4, page->va)){
-			file_write_at(page->file.file, page->va, page->file.read_bytes, page->file.ofs);
+			file_write_at(file_page->file, page->frame->kva, file_page->read_bytes, file_page->ofs);
 			pml4_set_dirty(current_pml4, page->va, false);
 		}
-		palloc_free_page(page->frame->kva);
-		pml4_clear_page(current_pml4, page->va);
+		vm_free_frame(page);
 	}
-
-	if (*page->file.remain_cnt == 1){
-		file_close(page->file.file);
-		free(page->file.remain_cnt);
-	} else {
-		(*page->file.remain_cnt)--;
-	}
-
-	free(page->frame);
 }
 
-/*** Dongdongbro ***/
+/*** Dongdongbro & haein ***/
 /* Do the mmap */
+/* 매핑 전체를 region 하나로 기술함. page는 처음 접근할 때 만들어짐 */
 void *
 do_mmap (void *addr, size_t length, int writable,
 		struct file *file, off_t offset) {
-			struct file *reopen_file = file_reopen(file);
-			if (reopen_file == NULL){
-				return NULL;
-			}
-			off_t now = offset;
-			int *remain_cnt = malloc(sizeof(int));
-			uint64_t temp_addr = addr;
-			uint64_t initial_addr = addr;
-			int temp_length = length;
-
-			*remain_cnt = 0;
-
-			while (temp_length > 0){
-				(*remain_cnt)++;
-				if (spt_find_page(&thread_current()->spt, temp_addr) != NULL){
-					return NULL;
-				}
-				temp_addr += PGSIZE;
-				temp_length -= PGSIZE;
-			}
-
-			int f_length = file_length(reopen_file);
-			temp_length = length;
-
-			while (temp_length > 0){
-				size_t page_read_bytes = f_length < PGSIZE ? f_length : PGSIZE;
-				size_t page_zero_bytes = PGSIZE - page_read_bytes;
-
-				struct lazy_info *lazy_info = malloc(sizeof(struct lazy_info));
-				lazy_info->file = reopen_file;
-				lazy_info->ofs = now;
-				lazy_info->read_bytes = page_read_bytes;
-				lazy_info->remain_cnt = remain_cnt;
-
-				if(!vm_alloc_page_with_initializer(VM_FILE, addr, writable, lazy_load_file, lazy_info)){
-					free(lazy_info);
-					return NULL;
-				}
-
-				f_length = f_length > PGSIZE ? f_length - PGSIZE:0;
-				temp_length -= PGSIZE;
-				addr += PGSIZE;
-				now += PGSIZE;
-			}
-
-		return initial_addr;
+	struct file *reopen_file = file_reopen(file);
+	if (reopen_file == NULL){
+		return NULL;
+	}
+
+	/* offset부터 파일 끝까지만 읽고, 매핑의 나머지는 0으로 채움 */
+	off_t f_length = file_length(reopen_file);
+	size_t file_bytes = f_length > offset ? f_length - offset : 0;
+	if (file_bytes > length){
+		file_bytes = length;
+	}
+
+	if (vm_region_add(&thread_current()->spt, addr, length, VM_FILE, writable,
+				lazy_load_file, reopen_file, offset, file_bytes) == NULL){
+		file_close(reopen_file);
+		return NULL;
+	}
+	return addr;
 }
 
 /*** haein ***/
 /* Do the munmap */
+/* ADDR은 mmap이 돌려준 주소여야 함. 익명 mmap도 여기서 풀지만
+ * heap region은 sbrk로만 줄일 수 있음 */
 void
 do_munmap (void *addr) {
 	struct supplemental_page_table *spt = &thread_current() -> spt;
-	int remain_cnt = *spt_find_page(spt, addr)->file.remain_cnt;
+	struct vm_region *region = vm_region_find(spt, addr);
+
+	if (region == NULL || region->start != addr || region == spt->heap
+		|| (region->type != VM_FILE && region->type != VM_ANON)) {
+		return;
+	}
+	if (region->type == VM_FILE) {
+		file_region_writeback(region, region->start, region->end);
+	}
+	vm_region_remove(spt, region); // 접근했던 page만 spt_remove_page
+}
+
+/*** haein ***/
+/* Do the msync */
+/* [ADDR, ADDR + LENGTH)에 걸친 mmap들의 dirty page를 지금 파일에 씀.
+ * 매핑된 곳이 하나도 없으면 false */
+bool
+do_msync (void *addr, size_t length) {
+	struct supplemental_page_table *spt = &thread_current()->spt;
+	uint8_t *end = (uint8_t *) addr + ROUND_UP(length, PGSIZE);
+	bool mapped = false;
+	struct list_elem *e;
 
-	while (remain_cnt) {
-		struct page *munmap_page = spt_find_page(spt, addr);
+	for (e = list_begin(&spt->regions); e != list_end(&spt->regions); e = list_next(e)) {
+		struct vm_region *region = list_entry(e, struct vm_region, elem);
 
-		if (munmap_page == NULL) {
-			goto err;
+		if (region->type != VM_FILE || region->end <= addr || (uint8_t *) region->start >= end) {
+			continue;
 		}
+		mapped = true;
+		file_region_writeback(region,
+				addr > region->start ? addr : region->start,
+				end < (uint8_t *) region->end ? end : region->end);
+	}
+	return mapped;
+}
+
+/*** haein ***/
+/* Write the dirty resident pages of REGION in [START, END), which must be
+ * mapped in the current process, back to the region's file. The pages
+ * are visited in address order, which is also file order, and each run
+ * of adjacent dirty pages (up to WRITEBACK_BATCH) is copied into one
+ * buffer and written with a single file_write_at. */
+void
+file_region_writeback (struct vm_region *region, void *start, void *end) {
+	struct thread *t = thread_current();
+	uint8_t *buf = palloc_get_multiple(0, WRITEBACK_BATCH);
+	size_t run_bytes = 0;
+	off_t run_ofs = 0;
+
+	for (uint8_t *va = start; va < (uint8_t *) end; va += PGSIZE) {
+		struct page *page = page_lookup(&t->spt, va);
+
+		if (page == NULL || page->operations->type != VM_FILE || page->frame == NULL
+				|| !pml4_is_dirty(t->pml4, va)) {
+			writeback_flush(region->file, buf, &run_bytes, run_ofs);
+			continue;
+		}
+
+		/* 복사 전에 지워야 복사 뒤의 write가 다음 writeback에 잡힘 */
+		struct file_page *file_page = &page->file;
+		pml4_set_dirty(t->pml4, va, false);
 
-		spt_remove_page(spt, munmap_page); // vm_dealloc_page (page) -> destroy(page) free(page)
-		addr += PGSIZE;
-		remain_cnt--;
+		/* buffer를 못 구했으면 page 하나씩 씀 */
+		if (buf == NULL) {
+			file_write_at(file_page->file, page->frame->kva, file_page->read_bytes, file_page->ofs);
+			continue;
+		}
+
+		if (run_bytes == 0) {
+			run_ofs = file_page->ofs;
+		}
+		memcpy(buf + run_bytes, page->frame->kva, file_page->read_bytes);
+		run_bytes += file_page->read_bytes;
+
+		/* 파일 끝 page 뒤로는 이어 쓸 수 없음 */
+		if (file_page->read_bytes < PGSIZE || run_bytes == WRITEBACK_BATCH * PGSIZE) {
+			writeback_flush(region->file, buf, &run_bytes, run_ofs);
+		}
 	}
+	writeback_flush(region->file, buf, &run_bytes, run_ofs);
 
-	err:
-		return;
+	if (buf != NULL) {
+		palloc_free_multiple(buf, WRITEBACK_BATCH);
+	}
+}
+
+/*** haein ***/
+/* Write the BYTES collected in BUF at OFS of FILE, if any, and empty the run. */
+static void
+writeback_flush (struct file *file, const void *buf, size_t *bytes, off_t ofs) {
+	if (*bytes > 0) {
+		file_write_at(file, buf, *bytes, ofs);
+		*bytes = 0;
+	}
 }
 
 
@@ -186,7 +243,7 @@ lazy_load_file (struct page *page, void *aux){
 	}
 
 	memset(page->frame->kva + lazy_info->read_bytes, 0, PGSIZE - lazy_info->read_bytes);
-	free(lazy_info);
+	slab_free(&lazy_info_slab, lazy_info);
 
 	return true;
 }
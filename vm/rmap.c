@@ -0,0 +1,186 @@
+/* rmap.c: Reverse mapping from a frame to every PTE that maps it. */
+
+#include "vm/rmap.h"
+#include "vm/vm.h"
+#include <debug.h>
+#include <list.h>
+#include "threads/mmu.h"
+#include "threads/slab.h"
+
+/* page table 하나에서 frame을 가리키는 매핑 */
+struct rmap_entry {
+	uint64_t *pml4;
+	void *va;
+	struct page *page;			/* va에 있는 page */
+	struct list_elem elem;		/* frame->mappings */
+};
+
+static struct slab_cache rmap_slab;
+
+/*** haein ***/
+void
+rmap_init (void) {
+	slab_cache_init (&rmap_slab, "rmap_entry", sizeof (struct rmap_entry), NULL);
+}
+
+/*** haein ***/
+/* Record that PAGE, in the address space of PML4, now maps FRAME. */
+void
+rmap_add (struct frame *frame, uint64_t *pml4, struct page *page) {
+	struct rmap_entry *e = slab_alloc (&rmap_slab);
+
+	if (e == NULL) {
+		PANIC ("rmap: out of kernel memory");
+	}
+	e->pml4 = pml4;
+	e->va = page->va;
+	e->page = page;
+	list_push_back (&frame->mappings, &e->elem);
+}
+
+/*** haein ***/
+/* Forget the mapping of FRAME at VA in PML4, if there is one. The PTE
+ * itself is left alone. */
+void
+rmap_remove (struct frame *frame, uint64_t *pml4, void *va) {
+	struct list_elem *el;
+
+	for (el = list_begin (&frame->mappings); el != list_end (&frame->mappings);
+			el = list_next (el)) {
+		struct rmap_entry *e = list_entry (el, struct rmap_entry, elem);
+
+		if (e->pml4 == pml4 && e->va == va) {
+			list_remove (&e->elem);
+			slab_free (&rmap_slab, e);
+			return;
+		}
+	}
+}
+
+/*** haein ***/
+/* Returns the number of PTEs that map FRAME. */
+size_t
+rmap_count (struct frame *frame) {
+	return list_size (&frame->mappings);
+}
+
+/*** haein ***/
+/* If exactly one page maps FRAME, returns it and stores its pml4 in
+ * *PML4. Otherwise returns NULL. */
+struct page *
+rmap_single (struct frame *frame, uint64_t **pml4) {
+	if (list_empty (&frame->mappings)
+			|| list_begin (&frame->mappings) != list_rbegin (&frame->mappings)) {
+		return NULL;
+	}
+	struct rmap_entry *e = list_entry (list_front (&frame->mappings),
+			struct rmap_entry, elem);
+	*pml4 = e->pml4;
+	return e->page;
+}
+
+/*** haein ***/
+/* Returns true if any mapper accessed FRAME since its bit was last
+ * cleared. */
+bool
+rmap_is_accessed (struct frame *frame) {
+	struct list_elem *el;
+
+	for (el = list_begin (&frame->mappings); el != list_end (&frame->mappings);
+			el = list_next (el)) {
+		struct rmap_entry *e = list_entry (el, struct rmap_entry, elem);
+
+		if (pml4_is_accessed (e->pml4, e->va)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*** haein ***/
+/* Like rmap_is_accessed(), and clears the accessed bit in every mapper. */
+bool
+rmap_test_and_clear_accessed (struct frame *frame) {
+	struct list_elem *el;
+	bool accessed = false;
+
+	for (el = list_begin (&frame->mappings); el != list_end (&frame->mappings);
+			el = list_next (el)) {
+		struct rmap_entry *e = list_entry (el, struct rmap_entry, elem);
+
+		if (pml4_is_accessed (e->pml4, e->va)) {
+			pml4_set_accessed (e->pml4, e->va, false);
+			accessed = true;
+		}
+	}
+	return accessed;
+}
+
+/*** haein ***/
+/* Returns true if any mapper wrote to FRAME. */
+bool
+rmap_is_dirty (struct frame *frame) {
+	struct list_elem *el;
+
+	for (el = list_begin (&frame->mappings); el != list_end (&frame->mappings);
+			el = list_next (el)) {
+		struct rmap_entry *e = list_entry (el, struct rmap_entry, elem);
+
+		if (pml4_is_dirty (e->pml4, e->va)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*** haein ***/
+/* Returns the page of the first mapping of FRAME, or NULL. */
+struct page *
+rmap_first (struct frame *frame) {
+	if (list_empty (&frame->mappings)) {
+		return NULL;
+	}
+	return list_entry (list_front (&frame->mappings), struct rmap_entry, elem)->page;
+}
+
+/*** haein ***/
+/* Call ACTION with AUX on the page of every mapping of FRAME. */
+void
+rmap_apply (struct frame *frame, rmap_action_func *action, void *aux) {
+	struct list_elem *el;
+
+	for (el = list_begin (&frame->mappings); el != list_end (&frame->mappings);
+			el = list_next (el)) {
+		action (list_entry (el, struct rmap_entry, elem)->page, aux);
+	}
+}
+
+/*** haein ***/
+/* Remove FRAME from every page table that maps it. The mappings are kept
+ * until rmap_detach_all(), and pml4_clear_page leaves the dirty bit in
+ * each PTE, so the owners can still tell whether they wrote to it. */
+void
+rmap_unmap_all (struct frame *frame) {
+	struct list_elem *el;
+
+	for (el = list_begin (&frame->mappings); el != list_end (&frame->mappings);
+			el = list_next (el)) {
+		struct rmap_entry *e = list_entry (el, struct rmap_entry, elem);
+
+		pml4_clear_page (e->pml4, e->va);
+	}
+}
+
+/*** haein ***/
+/* FRAME, unmapped by rmap_unmap_all(), has been evicted: every page that
+ * mapped it forgets it, and the mappings are dropped. */
+void
+rmap_detach_all (struct frame *frame) {
+	while (!list_empty (&frame->mappings)) {
+		struct rmap_entry *e = list_entry (list_pop_front (&frame->mappings),
+				struct rmap_entry, elem);
+
+		e->page->frame = NULL;
+		slab_free (&rmap_slab, e);
+	}
+}
@@ -2,4 +2,7 @@ vm_SRC = vm/vm.c          # Main api proxy
 vm_SRC += vm/uninit.c     # Uninitialized page
 vm_SRC += vm/anon.c       # Anonymous page
 vm_SRC += vm/file.c       # File mapped page
+vm_SRC += vm/zswap.c      # Compressed swap tier
+vm_SRC += vm/evict.c      # Page replacement policies
+vm_SRC += vm/rmap.c       # Reverse mapping
 vm_SRC += vm/inspect.c    # Testing utility
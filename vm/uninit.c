@@ -65,5 +65,5 @@ uninit_destroy (struct page *page) {
 	struct uninit_page *uninit UNUSED = &page->uninit;
 	/* TODO: Fill this function.
 	 * TODO: If you don't have anything to do, just return.  */
-	free(uninit->aux);
+	slab_free(&lazy_info_slab, uninit->aux);
 }
@@ -3,17 +3,77 @@
 #include "threads/malloc.h"
 #include "vm/vm.h"
 #include "vm/inspect.h"
+#include "vm/evict.h"
+#include "vm/rmap.h"
 #include "threads/mmu.h"
 #include "threads/vaddr.h"
 #include "lib/kernel/hash.h"
 #include "threads/malloc.h"
 #include "userprog/process.h"
 #include "lib/kernel/list.h" /*** haein ***/
+#include "threads/synch.h"
+#include <round.h>
 #include <string.h>
 
-static struct list frame_table;			/*** GrilledSalmon ***/
+/* user pool의 물리 frame마다 하나씩 있는 frame descriptor 배열.
+ * frame_table[i]는 frame_base + i * PGSIZE에 있는 frame을 나타냄 */
+static struct frame *frame_table;		/*** GrilledSalmon ***/
+static uint8_t *frame_base;				/* user pool의 첫 page (kva) */
+static size_t frame_table_size;			/* user pool의 page 수 */
+static struct lock frame_lock;			/* frame_table, share_cnt, 교체 정책 보호 */
+
+static size_t free_frames;				/* user pool에 남아 있는 frame 수 */
+
+/* 읽기만 한 demand-zero page가 모두 함께 쓰는 0으로 채워진 frame.
+ * frame_table 밖(kernel pool)에 있으므로 evict되거나 해제되지 않음 */
+static struct frame zero_frame;
+
+/* Reclaim daemon: free frame이 low 밑으로 내려가면 깨어나서 high까지 미리 evict.
+ * -wm-low, -wm-high 로 조절 가능하고 0이면 user pool 크기에서 정함 */
+size_t reclaim_low_wm;
+size_t reclaim_high_wm;
+static struct semaphore reclaim_sema;
+static bool reclaim_pending;			/* 이미 daemon을 깨웠는지 */
+
+/* Writeback thread: 쫓아낼 dirty page를 faulter 대신 디스크에 씀.
+ * queue에 든 frame은 매핑이 지워지고 pin 되어 있어 다시 victim이 되지 않으며,
+ * 다 쓰고 나면 user pool로 돌아감. 모두 frame_lock으로 보호 */
+#define WRITEBACK_QUEUE_MAX 32			/* 쓰는 중이거나 기다리는 frame 수 상한 */
+#define WRITEBACK_SCAN 8				/* clean victim을 찾는 동안 queue로 넘길 dirty frame 수 */
+static struct list writeback_queue;
+static size_t writeback_cnt;			/* queue에 있거나 쓰는 중인 frame 수 */
+static struct condition writeback_work;	/* queue에 frame이 들어옴 */
+static struct condition writeback_done;	/* writeback이 끝나 frame이 풀려남 */
+
+/* 새로 만들어지는 프로세스의 rss 상한 (page 수, 0이면 제한 없음). -rss= 로 정함 */
+size_t rss_default_limit;
+
+/* 여러 프로세스가 같은 실행 파일의 읽기 전용 segment를 하나의 frame으로 나눠 씀.
+ * entry는 frame이 해제되거나 evict될 때 함께 지워지므로, 살아 있는 동안 그 파일을
+ * 연 프로세스가 최소 하나는 있음 (inode가 바뀌어 재사용될 일이 없음) */
+struct shared_text {
+	struct inode *inode;
+	off_t ofs;
+	size_t read_bytes;
+	struct frame *frame;
+	struct hash *table;					/* text_table 또는 file_table */
+	struct hash_elem elem;
+};
+static struct hash text_table;			/* frame_lock으로 보호 */
+
+/* 같은 파일을 mmap한 page들도 (inode, page offset)마다 frame 하나를 함께 씀.
+ * 모든 mapper와 read/write system call이 같은 내용을 보게 됨. entry는
+ * shared_text와 같은 방식으로 관리되고 frame_lock으로 보호됨 */
+static struct hash file_table;
+
+#define SWAP_CLUSTER 8					/* 한 번에 swap out 할 anon page 수 */
+#define FAULT_AROUND_PAGES 8			/* file/segment page fault 때 함께 채울 window 크기 (2의 거듭제곱) */
+
+/* 자주 만들고 지우는 VM 객체들은 malloc 대신 타입별 slab cache에서 가져옴 */
+struct slab_cache page_slab;
+struct slab_cache lazy_info_slab;
+static struct slab_cache region_slab;
 
-struct page *page_lookup (struct hash *h, const void *va); /*** haein ***/
 
 /*** Dongdongbro ***/
 unsigned page_hash (const struct hash_elem *h_elem, void *aux UNUSED);
@@ -21,7 +81,46 @@ bool page_less (const struct hash_elem *h_elem1, const struct hash_elem *h_elem2
 
 /*** GrilledSalmon ***/
 void spt_hash_destructor (struct hash_elem *e, void *aux); 	
-static void copy_parent_file (struct file *parent_file, int parent_remain_cnt, tid_t child_tid, bool is_uninit, void *aux);
+static struct page *vm_new_page (struct supplemental_page_table *spt, enum vm_type type, void *upage, bool writable, vm_initializer *init, void *aux);
+static struct page *vm_region_fault_in (struct supplemental_page_table *spt, struct vm_region *region, void *va);
+static bool vm_range_is_free (struct supplemental_page_table *spt, void *start, void *end);
+static bool vm_share_frame (struct page *dst_page, struct page *src_page, struct thread *parent);
+static void frame_table_init (void);
+static void reclaim_init (void);
+static void reclaimd (void *aux);
+static void frame_unref (struct frame *frame);
+static struct page *frame_page (struct frame *frame);
+static void frame_detach (struct frame *frame);
+static void frame_charge (struct frame *frame, struct thread *t);
+static void frame_uncharge (struct frame *frame);
+static bool rss_at_limit (struct thread *t);
+static struct frame *vm_get_own_victim (struct thread *t);
+static struct frame *vm_evict_frame (struct thread *owner);
+static struct frame *vm_evict_victim (struct frame *victim);
+static bool vm_needs_writeback (struct frame *frame);
+static void vm_queue_writeback (struct frame *frame);
+static void writeback_init (void);
+static void writebackd (void *aux);
+static bool vm_is_demand_zero (struct page *page);
+static bool vm_map_zero_page (struct page *page);
+static void vm_fault_around (struct page *page);
+static bool vm_prefetch_page (struct supplemental_page_table *spt, void *va);
+static bool vm_discard_page (struct supplemental_page_table *spt, void *va,
+		bool in_region);
+static bool vm_advise_pages (struct supplemental_page_table *spt, uint8_t *start,
+		uint8_t *end, enum vm_advice advice, bool in_region);
+static bool vm_text_key (struct page *page, uint64_t *pml4, struct shared_text *key);
+static bool vm_share_text (struct page *page, struct shared_text *key);
+static void vm_publish_text (struct frame *frame, struct shared_text *key);
+static void frame_forget_text (struct frame *frame);
+static uint64_t text_hash (const struct hash_elem *e, void *aux);
+static bool text_less (const struct hash_elem *a, const struct hash_elem *b, void *aux);
+static bool vm_file_key (struct page *page, uint64_t *pml4, struct shared_text *key);
+static bool vm_share_file (struct page *page, struct shared_text *key);
+static struct frame *vm_file_lookup (struct inode *inode, off_t ofs, size_t *read_bytes);
+static bool vm_file_fault_shares (struct page *page);
+static uint64_t file_key_hash (const struct hash_elem *e, void *aux);
+static bool file_key_less (const struct hash_elem *a, const struct hash_elem *b, void *aux);
 
 /* Initializes the virtual memory subsystem by invoking each subsystem's
  * intialize codes. */
@@ -35,7 +134,167 @@ vm_init (void) {
 	register_inspect_intr ();
 	/* DO NOT MODIFY UPPER LINES. */
 	/* TODO: Your code goes here. */
-	list_init(&frame_table);
+	slab_cache_init(&page_slab, "page", sizeof (struct page), NULL);
+	slab_cache_init(&lazy_info_slab, "lazy_info", sizeof (struct lazy_info), NULL);
+	slab_cache_init(&region_slab, "vm_region", sizeof (struct vm_region), NULL);
+	frame_table_init();
+	lock_init(&frame_lock);
+	evict_init(frame_table, frame_table_size);
+	rmap_init();
+	reclaim_init();
+	writeback_init();
+
+	zero_frame.kva = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+	list_init (&zero_frame.mappings);	/* 매핑은 기록하지 않음 */
+	hash_init (&text_table, text_hash, text_less, NULL);
+	hash_init (&file_table, file_key_hash, file_key_less, NULL);
+}
+
+/*** haein ***/
+/* Settle the watermarks and start the reclaim daemon. */
+static void
+reclaim_init (void) {
+	if (reclaim_low_wm == 0) {
+		reclaim_low_wm = frame_table_size / 32 + 1;
+	}
+	if (reclaim_high_wm == 0) {
+		reclaim_high_wm = reclaim_low_wm * 2;
+	}
+	if (reclaim_high_wm < reclaim_low_wm) {
+		reclaim_high_wm = reclaim_low_wm;
+	}
+	if (reclaim_high_wm > frame_table_size) {
+		reclaim_high_wm = frame_table_size;
+	}
+
+	sema_init(&reclaim_sema, 0);
+	reclaim_pending = false;
+	thread_create("reclaimd", PRI_DEFAULT, reclaimd, NULL);
+}
+
+/*** haein ***/
+/* Reclaim daemon. Each time it is woken it evicts frames until the user
+ * pool has reclaim_high_wm free frames again, dropping frame_lock between
+ * victims so faulting threads are not held up behind the whole batch. */
+static void
+reclaimd (void *aux UNUSED) {
+	for (;;) {
+		sema_down(&reclaim_sema);
+
+		lock_acquire(&frame_lock);
+		while (free_frames < reclaim_high_wm) {
+			struct frame *victim = vm_evict_frame(NULL);
+			if (victim == NULL) {
+				break;
+			}
+			frame_unref(victim);
+
+			lock_release(&frame_lock);
+			lock_acquire(&frame_lock);
+		}
+		reclaim_pending = false;
+		lock_release(&frame_lock);
+	}
+}
+
+/*** haein ***/
+/* Start the writeback thread. */
+static void
+writeback_init (void) {
+	list_init(&writeback_queue);
+	writeback_cnt = 0;
+	cond_init(&writeback_work);
+	cond_init(&writeback_done);
+	thread_create("writebackd", PRI_DEFAULT, writebackd, NULL);
+}
+
+/*** haein ***/
+/* Writeback thread. Writes the queued dirty victims out without
+ * frame_lock held, anonymous ones SWAP_CLUSTER at a time so they share
+ * one swap-out, then frees their frames and wakes whoever is waiting
+ * for a frame or for one of those pages. */
+static void
+writebackd (void *aux UNUSED) {
+	struct frame *frames[SWAP_CLUSTER];
+	struct page *pages[SWAP_CLUSTER];
+
+	lock_acquire(&frame_lock);
+	for (;;) {
+		while (list_empty(&writeback_queue)) {
+			cond_wait(&writeback_work, &frame_lock);
+		}
+
+		size_t cnt = 0;
+		frames[cnt++] = list_entry(list_pop_front(&writeback_queue), struct frame, wb_elem);
+		/* 공유 frame은 파일 page일 때만 queue에 들어옴 */
+		bool anon = frame_page(frames[0])->operations->type == VM_ANON;
+		if (anon) {
+			struct list_elem *e = list_begin(&writeback_queue);
+			while (e != list_end(&writeback_queue) && cnt < SWAP_CLUSTER) {
+				struct frame *frame = list_entry(e, struct frame, wb_elem);
+
+				e = list_next(e);
+				if (frame_page(frame)->operations->type == VM_ANON) {
+					list_remove(&frame->wb_elem);
+					frames[cnt++] = frame;
+				}
+			}
+		}
+		for (size_t i = 0; i < cnt; i++) {
+			pages[i] = frame_page(frames[i]);
+		}
+		lock_release(&frame_lock);
+
+		/* 매핑이 지워졌고 pin 되어 있으므로 lock 없이 읽어도 내용이 바뀌지 않음 */
+		if (anon) {
+			anon_swap_out_cluster(pages, cnt);
+		} else {
+			swap_out(pages[0]);
+		}
+
+		lock_acquire(&frame_lock);
+		for (size_t i = 0; i < cnt; i++) {
+			frames[i]->pin_cnt--;
+			frames[i]->writeback = false;
+			frame_detach(frames[i]);
+			frame_unref(frames[i]);
+		}
+		writeback_cnt -= cnt;
+		cond_broadcast(&writeback_done, &frame_lock);
+	}
+}
+
+/*** haein ***/
+/* Allocate one frame descriptor for every page of the user pool.
+ * The table lives in the kernel pool for the whole uptime, so claiming a
+ * frame never goes through malloc. */
+static void
+frame_table_init (void) {
+	void *base;
+
+	frame_table_size = palloc_user_pool (&base);
+	frame_base = base;
+
+	size_t table_pages = DIV_ROUND_UP (frame_table_size * sizeof (struct frame), PGSIZE);
+	frame_table = palloc_get_multiple (PAL_ASSERT | PAL_ZERO, table_pages);
+
+	for (size_t i = 0; i < frame_table_size; i++) {
+		frame_table[i].kva = frame_base + i * PGSIZE;
+		list_init(&frame_table[i].mappings);
+	}
+	free_frames = frame_table_size;
+}
+
+/*** haein ***/
+/* Returns the descriptor of the user frame at KVA. */
+static struct frame *
+frame_of (void *kva) {
+	ASSERT (pg_ofs (kva) == 0);
+	ASSERT ((uint8_t *) kva >= frame_base);
+
+	size_t idx = pg_no (kva) - pg_no (frame_base);
+	ASSERT (idx < frame_table_size);
+	return &frame_table[idx];
 }
 
 /* Get the type of the page. This function is useful if you want to know the
@@ -55,7 +314,7 @@ page_get_type (struct page *page) {
 /* Helpers */
 static struct frame *vm_get_victim (void);
 static bool vm_do_claim_page (struct page *page);
-static struct frame *vm_evict_frame (void);
+static bool vm_do_claim_page_in (struct page *page, uint64_t *pml4);
 
 /*** GrilledSalmon ***/
 /* Create the pending page object with initializer. If you want to create a
@@ -70,50 +329,286 @@ vm_alloc_page_with_initializer (enum vm_type type, void *upage, bool writable,
 	struct supplemental_page_table *spt = &thread_current ()->spt;
 	upage = pg_round_down(upage);
 
-	/* Check wheter the upage is already occupied or not. */
-	if (spt_find_page (spt, upage) == NULL) {
-		/* TODO: Create the page, fetch the initialier according to the VM type,
-		 * TODO: and then create "uninit" page struct by calling uninit_new. You
-		 * TODO: should modify the field after calling the uninit_new. */
-		struct page *page = malloc(sizeof(struct page));
-		bool (*initializer)(struct page *, enum vm_type, void *);
+	/* Check wheter the upage is already occupied or not.
+	 * region 안의 page를 새로 만들어 버리지 않도록 hash만 확인 */
+	if (page_lookup (spt, upage) == NULL) {
+		return vm_new_page (spt, type, upage, writable, init, aux) != NULL;
+	}
+	return false;
+}
 
-		switch (VM_TYPE(type))
-		{
-		case VM_ANON:
-			initializer = anon_initializer;
-			break;
+/*** GrilledSalmon & haein ***/
+/* Create the uninit page for UPAGE and insert it into SPT.
+ * Returns the page, or NULL if memory runs out. */
+static struct page *
+vm_new_page (struct supplemental_page_table *spt, enum vm_type type, void *upage,
+		bool writable, vm_initializer *init, void *aux) {
+	/* TODO: Create the page, fetch the initialier according to the VM type,
+	 * TODO: and then create "uninit" page struct by calling uninit_new. You
+	 * TODO: should modify the field after calling the uninit_new. */
+	struct page *page = slab_alloc(&page_slab);
+	bool (*initializer)(struct page *, enum vm_type, void *);
+
+	if (page == NULL) {
+		return NULL;
+	}
+
+	switch (VM_TYPE(type))
+	{
+	case VM_ANON:
+		initializer = anon_initializer;
+		break;
+
+	case VM_FILE:
+		initializer = file_backed_initializer;
+		break;
+
+	default:
+		initializer = NULL;
+		break;
+	}
+
+	uninit_new(page, upage, init, type, aux, initializer);
+	page->writable = writable;
+
+	/* TODO: Insert the page into the spt. */
+	if (!spt_insert_page(spt, page)) {
+		slab_free(&page_slab, page);
+		return NULL;
+	}
+	return page;
+}
+
+/*** haein ***/
+/* Find VA from spt and return page. On error, return NULL. */
+/* VA와 상응하는 struct page를 supplemental page table에서 찾아준다. 실패 시, NULL을 리턴한다. */
+struct page *
+spt_find_page (struct supplemental_page_table *spt, void *va) {
+	struct page *page = page_lookup(spt, va);
+
+	/* region 안인데 아직 아무도 건드리지 않은 page라면 지금 만들어 줌 */
+	if (page == NULL) {
+		struct vm_region *region = vm_region_find (spt, va);
+		if (region != NULL) {
+			page = vm_region_fault_in (spt, region, pg_round_down (va));
+		}
+	}
+	return page;
+}
+
+/*** haein ***/
+/* Describe [START, START + LENGTH) of SPT as one region whose pages are
+ * only created when first touched. Page I of the region holds
+ * min(PGSIZE, FILE_BYTES - I * PGSIZE) bytes of FILE at OFS + I * PGSIZE
+ * (the running executable if FILE is null) followed by zeros, and is
+ * filled by INIT. On success the region owns FILE. Returns NULL if the
+ * range wraps, reaches kernel space or overlaps anything already mapped. */
+struct vm_region *
+vm_region_add (struct supplemental_page_table *spt, void *start, size_t length,
+		enum vm_type type, bool writable, vm_initializer *init,
+		struct file *file, off_t ofs, size_t file_bytes) {
+	ASSERT (pg_ofs (start) == 0);
+
+	uint8_t *end = (uint8_t *) start + ROUND_UP (length, PGSIZE);
+	if (length == 0 || end <= (uint8_t *) start || (uint64_t) end > KERN_BASE
+			|| !vm_range_is_free (spt, start, end)) {
+		return NULL;
+	}
 
-		case VM_FILE:
-			initializer = file_backed_initializer;
+	struct vm_region *region = slab_alloc (&region_slab);
+	if (region == NULL) {
+		return NULL;
+	}
+	region->start = start;
+	region->end = end;
+	region->type = type;
+	region->writable = writable;
+	region->init = init;
+	region->file = file;
+	region->ofs = ofs;
+	region->file_bytes = file_bytes;
+	region->advice = VM_ADV_NORMAL;
+
+	/* START 순서를 유지하며 끼워 넣음 */
+	struct list_elem *e;
+	for (e = list_begin (&spt->regions); e != list_end (&spt->regions); e = list_next (e)) {
+		if (list_entry (e, struct vm_region, elem)->start > start) {
 			break;
+		}
+	}
+	list_insert (e, &region->elem);
+	return region;
+}
 
-		default:
-			initializer = NULL;
+/*** haein ***/
+/* Returns the region of SPT containing VA, or NULL. A process has only
+ * a handful of regions (segments, heap, mmaps), so they stay in a sorted
+ * list; faults come in runs within one region, so the last hit is
+ * checked first and most lookups never walk the list. */
+struct vm_region *
+vm_region_find (struct supplemental_page_table *spt, const void *va) {
+	struct vm_region *hint = spt->region_hint;
+	struct list_elem *e;
+
+	if (hint != NULL && hint->start <= va && va < hint->end) {
+		return hint;
+	}
+	for (e = list_begin (&spt->regions); e != list_end (&spt->regions); e = list_next (e)) {
+		struct vm_region *region = list_entry (e, struct vm_region, elem);
+		if (va < region->start) {
 			break;
 		}
+		if (va < region->end) {
+			spt->region_hint = region;
+			return region;
+		}
+	}
+	return NULL;
+}
+
+/*** haein ***/
+/* Destroy the pages of REGION that were ever touched, writing back dirty
+ * file pages, then drop the region and close its file. */
+void
+vm_region_remove (struct supplemental_page_table *spt, struct vm_region *region) {
+	for (uint8_t *va = region->start; va < (uint8_t *) region->end; va += PGSIZE) {
+		struct page *page = page_lookup (spt, va);
+		if (page != NULL) {
+			spt_remove_page (spt, page);
+		}
+	}
 
-		uninit_new(page, upage, init, type, aux, initializer);
-		page->writable = writable;
+	if (spt->region_hint == region) {
+		spt->region_hint = NULL;
+	}
+	list_remove (&region->elem);
+	file_close (region->file);
+	slab_free (&region_slab, region);
+}
+
+/*** haein ***/
+/* Create the uninit page for VA, which lies in REGION. */
+static struct page *
+vm_region_fault_in (struct supplemental_page_table *spt, struct vm_region *region, void *va) {
+	/* 익명 mmap과 heap은 채울 내용이 없으므로 0으로 채워지는 anon page */
+	if (region->init == NULL) {
+		return vm_new_page (spt, region->type, va, region->writable, NULL, NULL);
+	}
+
+	struct lazy_info *info = slab_alloc (&lazy_info_slab);
+	if (info == NULL) {
+		return NULL;
+	}
+
+	size_t skip = (uint8_t *) va - (uint8_t *) region->start;
+	info->file = region->file;
+	info->ofs = region->ofs + skip;
+	info->read_bytes = 0;
+	if (region->file_bytes > skip) {
+		info->read_bytes = region->file_bytes - skip < PGSIZE ? region->file_bytes - skip : PGSIZE;
+	}
+	info->region = region;
+
+	struct page *page = vm_new_page (spt, region->type, va, region->writable, region->init, info);
+	if (page == NULL) {
+		slab_free (&lazy_info_slab, info);
+	}
+	return page;
+}
+
+/*** haein ***/
+/* Returns true if nothing in SPT maps any page of [START, END). */
+static bool
+vm_range_is_free (struct supplemental_page_table *spt, void *start, void *end) {
+	struct list_elem *e;
 
-		/* TODO: Insert the page into the spt. */
-		if (!spt_insert_page(spt, page)) {
-			free(page);
-			goto err;
+	for (e = list_begin (&spt->regions); e != list_end (&spt->regions); e = list_next (e)) {
+		struct vm_region *region = list_entry (e, struct vm_region, elem);
+		if (region->start < end && start < region->end) {
+			return false;
 		}
+	}
 
+	/* region 밖의 page(stack 등)는 개수가 적으므로 보통은 hash를 도는 쪽이 쌈 */
+	size_t range_pages = ((uint8_t *) end - (uint8_t *) start) / PGSIZE;
+	if (hash_size (&spt->h) < range_pages) {
+		struct hash_iterator i;
+		hash_first (&i, &spt->h);
+		while (hash_next (&i)) {
+			struct page *page = hash_entry (hash_cur (&i), struct page, hash_elem);
+			if (start <= page->va && page->va < end) {
+				return false;
+			}
+		}
 		return true;
 	}
-err:
-	return false;
+	for (uint8_t *va = start; va < (uint8_t *) end; va += PGSIZE) {
+		if (page_lookup (spt, va) != NULL) {
+			return false;
+		}
+	}
+	return true;
 }
 
 /*** haein ***/
-/* Find VA from spt and return page. On error, return NULL. */
-/* VA와 상응하는 struct page를 supplemental page table에서 찾아준다. 실패 시, NULL을 리턴한다. */
-struct page *
-spt_find_page (struct supplemental_page_table *spt, void *va) {
-	return page_lookup(&spt->h, va);
+/* Move the program break of the current process by INCREMENT bytes and
+ * return the old break, or (void *) -1 if the heap cannot grow that far
+ * or would shrink below its start. [heap_start, brk) is covered by one
+ * anonymous region whose pages are zero-filled on first touch; pages
+ * that fall off the end when the heap shrinks are dropped together with
+ * their frames and swap slots. */
+void *
+vm_sbrk (intptr_t increment) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	uint8_t *old_brk = spt->brk;
+	uint8_t *new_brk = old_brk + increment;
+
+	if ((increment > 0 && new_brk < old_brk) || (increment < 0 && new_brk > old_brk)
+			|| new_brk < (uint8_t *) spt->heap_start
+			|| new_brk > (uint8_t *) USER_STACK_LIMIT) {
+		return (void *) -1;
+	}
+
+	uint8_t *old_end = (uint8_t *) ROUND_UP ((uint64_t) old_brk, PGSIZE);
+	uint8_t *new_end = (uint8_t *) ROUND_UP ((uint64_t) new_brk, PGSIZE);
+	struct vm_region *heap = spt->heap;
+
+	if (new_end > old_end) {
+		if (heap == NULL) {
+			heap = vm_region_add (spt, spt->heap_start, new_end - (uint8_t *) spt->heap_start,
+					VM_ANON, true, NULL, NULL, 0, 0);
+			if (heap == NULL) {
+				return (void *) -1;
+			}
+			spt->heap = heap;
+		} else {
+			/* 그 사이에 mmap 등이 자리를 차지했으면 늘릴 수 없음 */
+			if (!vm_range_is_free (spt, old_end, new_end)) {
+				return (void *) -1;
+			}
+			heap->end = new_end;
+		}
+	} else if (new_end < old_end) {
+		for (uint8_t *va = new_end; va < old_end; va += PGSIZE) {
+			struct page *page = page_lookup (spt, va);
+			if (page != NULL) {
+				spt_remove_page (spt, page);
+			}
+		}
+		if (new_end == (uint8_t *) spt->heap_start) {
+			if (spt->region_hint == heap) {
+				spt->region_hint = NULL;
+			}
+			list_remove (&heap->elem);
+			slab_free (&region_slab, heap);
+			spt->heap = NULL;
+		} else {
+			heap->end = new_end;
+		}
+	}
+
+	spt->brk = new_brk;
+	return old_brk;
 }
 
 /*** GrilledSalmon ***/
@@ -124,6 +619,8 @@ spt_insert_page (struct supplemental_page_table *spt, struct page *page) {
 	/* TODO: Fill this function. */
 
 	if (hash_insert(&spt->h, &page->hash_elem) == NULL) {
+		/* 방금 만든 page는 곧 fault로 다시 찾게 되므로 slot을 이 page로 바꿔 둠 */
+		spt->cache[SPT_CACHE_SLOT (page->va)] = page;
 		succ = true;
 	}
 
@@ -133,32 +630,143 @@ spt_insert_page (struct supplemental_page_table *spt, struct page *page) {
 void
 spt_remove_page (struct supplemental_page_table *spt, struct page *page) {
 	hash_delete(&spt->h, &page->hash_elem);
+	if (spt->cache[SPT_CACHE_SLOT (page->va)] == page) {
+		spt->cache[SPT_CACHE_SLOT (page->va)] = NULL;
+	}
 	vm_dealloc_page (page);
 	return true;
 }
 
-/*** GrilledSalmon ***/
+/*** haein ***/
+/* Drop one reference to FRAME and free it once nobody maps it.
+ * Must hold frame_lock. */
+static void
+frame_unref (struct frame *frame) {
+	if (frame == &zero_frame) {
+		return;
+	}
+	ASSERT (frame->share_cnt > 0);
+
+	if (--frame->share_cnt > 0) {
+		/* 나눠 쓰던 page가 하나만 남으면 그 page가 다시 주인이 되어 evict될 수 있음 */
+		if (frame->share_cnt == 1 && frame->page == NULL) {
+			uint64_t *pml4;
+			struct page *page = rmap_single (frame, &pml4);
+
+			if (page != NULL) {
+				frame->page = page;
+				frame->pml4 = pml4;
+			}
+		}
+		return;
+	}
+	ASSERT (list_empty (&frame->mappings));
+
+	frame_forget_text (frame);
+	frame_uncharge (frame);
+	evict_remove (frame);
+	frame->page = NULL;
+	frame->pml4 = NULL;
+	palloc_free_page (frame->kva);
+	free_frames++;
+}
+
+/*** haein ***/
+/* Returns a page held in FRAME: its owner, or for a shared frame one of
+ * the pages that map it. Must hold frame_lock. */
+static struct page *
+frame_page (struct frame *frame) {
+	return frame->page != NULL ? frame->page : rmap_first (frame);
+}
+
+/*** haein ***/
+/* FRAME, unmapped everywhere, has been written out: every page that held
+ * it forgets it, and FRAME keeps only the reference of whoever evicted
+ * it. Must hold frame_lock. */
+static void
+frame_detach (struct frame *frame) {
+	if (frame->page != NULL) {
+		frame->page->frame = NULL;
+	}
+	rmap_detach_all (frame);
+	frame_forget_text (frame);
+	frame_uncharge (frame);
+	frame->page = NULL;
+	frame->share_cnt = 1;
+}
+
+/*** haein ***/
+/* Count FRAME, which now holds a page of T, in T's resident set.
+ * Must hold frame_lock. */
+static void
+frame_charge (struct frame *frame, struct thread *t) {
+	ASSERT (frame->owner == NULL);
+
+	frame->owner = t;
+	list_push_back (&t->frames, &frame->owner_elem);
+	t->rss++;
+}
+
+/*** haein ***/
+/* FRAME is freed, evicted or shared, so it stops counting against its
+ * owner. Must hold frame_lock. */
+static void
+frame_uncharge (struct frame *frame) {
+	if (frame->owner == NULL) {
+		return;
+	}
+	list_remove (&frame->owner_elem);
+	frame->owner->rss--;
+	frame->owner = NULL;
+}
+
+/*** haein ***/
+/* Returns true if T may not take another frame without giving one of
+ * its own back. */
+static bool
+rss_at_limit (struct thread *t) {
+	return t->rss_limit != 0 && t->rss >= t->rss_limit;
+}
+
+/*** GrilledSalmon & haein ***/
 /* Get the struct frame, that will be evicted. */
+/* 정책은 부팅 때 -evict=로 고름 (vm/evict.c). 고른 frame은 정책의 list에서 빠짐 */
 static struct frame *
 vm_get_victim (void) {
-	struct frame *victim = NULL;
 	 /* TODO: The policy for eviction is up to you. */
-	struct list_elem *elem;
-	ASSERT(!list_empty(&frame_table));
-	int count = 0;
-	for (elem=list_begin(&frame_table); elem!=list_end(&frame_table); elem=list_next(elem))
-	{	
-		victim = list_entry(elem, struct frame, frame_elem);
-		if (pml4_is_accessed(victim->pml4, victim->page->va)) {
-			pml4_set_accessed(victim->pml4, victim->page->va, false);
-		} else {
-			break;
-		}
+	ASSERT (lock_held_by_current_thread (&frame_lock));
+
+	struct frame *victim = evict_select ();
+	if (victim != NULL) {
+		evict_remove (victim);
 	}
-	/* 만약 리스트를 다 돌았는데 모두 accessed 상태면 자동으로 마지막 frame 리턴*/
 	return victim;
 }
 
+/*** haein ***/
+/* Choose a victim among the frames charged to T: a clock over T->frames
+ * that gives recently accessed frames a second chance. Returns NULL if
+ * none can be evicted. Must hold frame_lock. */
+static struct frame *
+vm_get_own_victim (struct thread *t) {
+	ASSERT (lock_held_by_current_thread (&frame_lock));
+
+	for (size_t scanned = 0; scanned < 2 * t->rss; scanned++) {
+		struct frame *frame = list_entry (list_pop_front (&t->frames), struct frame, owner_elem);
+		list_push_back (&t->frames, &frame->owner_elem);
+
+		if (frame->pin_cnt > 0) {
+			continue;
+		}
+		if (rmap_test_and_clear_accessed (frame)) {
+			continue;
+		}
+		evict_remove (frame);
+		return frame;
+	}
+	return NULL;
+}
+
 /*** haein ***/
 /* Evict one page and return the corresponding frame.
  * Return NULL on error.
@@ -166,55 +774,188 @@ vm_get_victim (void) {
  * 에러가 났을 때는 NULL을 리턴
  * 프레임 테이블에서 없애고 swap table에서도 없앰 (swap out)
  */
+/* OWNER가 NULL이 아니면 그 프로세스의 page만 내보냄 (rss 한도).
+ * 디스크에 써야 하는 victim은 writeback thread에 넘기고 쓸 것 없는 victim을
+ * 찾아봄. 그런 victim이 없고 queue에 frame이 남아 있으면 하나가 끝날 때까지
+ * 기다렸다가 victim부터 다시 고름. 기다릴 writeback도 없으면 NULL.
+ * 디스크에 쓰는 victim은 queue가 차 있어도 writeback thread에 넘기므로
+ * frame_lock을 잡은 채로 swap에 쓰는 일은 없음 */
 static struct frame *
-vm_evict_frame (void) {
-	struct frame *victim = vm_get_victim (); // 여기서 걸림!
-	/* TODO: swap out the victim and return the evicted frame. */
-	if (!victim) {
-		return NULL;
-	}
+vm_evict_frame (struct thread *owner) {
+	for (;;) {
+		size_t queued = 0;
+
+		for (;;) {
+			struct frame *victim = owner != NULL ? vm_get_own_victim (owner) : vm_get_victim ();
+			if (victim == NULL) {
+				break;
+			}
+			if (vm_needs_writeback (victim)) {
+				/* queue가 차 있어도 lock을 잡은 채로 쓰지 않고 넘긴 뒤 기다림 */
+				vm_queue_writeback (victim);
+				if (++queued < WRITEBACK_SCAN && writeback_cnt < WRITEBACK_QUEUE_MAX) {
+					continue;
+				}
+				break;
+			}
+			return vm_evict_victim (victim);
+		}
 
-	if (!list_remove(&victim->frame_elem)) { // frame table에서 삭제
-		return NULL;
+		/* rss 한도 때문이라면 queue에 넘긴 만큼 rss가 줄었으므로 기다리지 않음 */
+		if (owner != NULL || writeback_cnt == 0) {
+			return NULL;
+		}
+		cond_wait (&writeback_done, &frame_lock);
+
+		/* 다 쓴 frame은 user pool로 돌아가 있음 */
+		uint8_t *kva = palloc_get_page (PAL_USER);
+		if (kva != NULL) {
+			struct frame *frame = frame_of (kva);
+			free_frames--;
+			frame->share_cnt = 1;
+			return frame;
+		}
 	}
+}
 
-	if (!swap_out(victim->page)) { // swap_out 호출
+/*** haein ***/
+/* Write VICTIM's page out right away and return VICTIM, now empty.
+ * Returns NULL on error. Must hold frame_lock; it is dropped while a
+ * shared anonymous frame is written. */
+static struct frame *
+vm_evict_victim (struct frame *victim) {
+	/* TODO: swap out the victim and return the evicted frame. */
+	struct page *page = frame_page (victim);
+
+	/* 주인이 swap out 도중에 page를 수정하지 못하도록 먼저 매핑을 지움.
+	 * dirty bit은 pte에 그대로 남아 있음. 주인이 하나인 anon page와 dirty한
+	 * 파일 page는 writeback thread로 가므로 여기서 쓰는 것은 page cache
+	 * page와 공유 anon frame뿐 */
+	rmap_unmap_all(victim);
+
+	/* 여러 page가 같이 쓰던 anon frame은 slot 하나에 한 번만 쓰고
+	 * 모든 page가 그 slot을 가리키게 함 */
+	if (victim->page == NULL && page->operations->type == VM_ANON) {
+		/* 쓰는 동안에는 frame_lock을 놓음. writeback 중인 frame은 매핑이
+		 * 바뀌지 않고, mapper들의 fault와 exit는 writeback_done을 기다림 */
+		victim->pin_cnt++;
+		victim->writeback = true;
+		lock_release (&frame_lock);
+		anon_swap_out_shared (victim);
+		lock_acquire (&frame_lock);
+		victim->pin_cnt--;
+		victim->writeback = false;
+		cond_broadcast (&writeback_done, &frame_lock);
+	} else if (!swap_out(page)) { // swap_out 호출
 		return NULL;
-	} 
-	
-	pml4_clear_page(victim->pml4, victim->page->va); // pml4에서 삭제
+	}
 
+	/* 쫓겨난 page들은 더 이상 frame을 갖지 않음, frame은 그대로 재사용 */
+	frame_detach (victim);
 	return victim;
 }
 
+/*** haein ***/
+/* Returns true if evicting FRAME means writing it to disk: an anonymous
+ * page, or a dirty page of a file mapping. Kernel-owned frames and
+ * shared anonymous frames are always evicted in place. Must hold
+ * frame_lock. */
+static bool
+vm_needs_writeback (struct frame *frame) {
+	if (frame->pml4 == NULL) {
+		return false;
+	}
+	switch (frame_page (frame)->operations->type) {
+	case VM_ANON:
+		/* 공유 frame은 mapper 모두가 한 slot을 가리키도록 vm_evict_victim에서 씀 */
+		return frame->page != NULL;
+	case VM_FILE:
+		/* 검사한 뒤에 주인이 써서 dirty가 되지 않도록 매핑부터 지움.
+		 * 어느 쪽이든 내보낼 frame이고 dirty bit은 pte에 남아 있음 */
+		rmap_unmap_all (frame);
+		return rmap_is_dirty (frame);
+	default:
+		return false;
+	}
+}
+
+/*** haein ***/
+/* Unmap FRAME, just taken as a victim, and hand it to the writeback
+ * thread. The pages that map it keep FRAME until its contents are out;
+ * faults on them wait in vm_wait_writeback(). Must hold frame_lock. */
+static void
+vm_queue_writeback (struct frame *frame) {
+	/* dirty bit은 pte에 그대로 남아 있음 */
+	rmap_unmap_all (frame);
+	frame_forget_text (frame);
+	frame_uncharge (frame);
+	frame->pin_cnt++;
+	frame->writeback = true;
+	list_push_back (&writeback_queue, &frame->wb_elem);
+	writeback_cnt++;
+	cond_signal (&writeback_work, &frame_lock);
+}
+
+/*** haein ***/
+/* Wait until PAGE is not being written out by the writeback thread. */
+void
+vm_wait_writeback (struct page *page) {
+	lock_acquire (&frame_lock);
+	while (page->frame != NULL && page->frame->writeback) {
+		cond_wait (&writeback_done, &frame_lock);
+	}
+	lock_release (&frame_lock);
+}
 
 /*** GrilledSalmon & haein ***/
 /* palloc() and get frame. If there is no available page, evict the page
- * and return it. This always return valid address. That is, if the user pool
- * memory is full, this function evicts the frame to get the available memory
- * space.*/
+ * and return it. That is, if the user pool memory is full, this function
+ * evicts the frame to get the available memory space. Returns NULL only if
+ * nothing can be evicted. */
 /* palloc()과 프레임을 얻어옵니다. 만약 이용가능한 페이지가 없으면, 페이지를 지우고 이를 리턴합니다.
-항상 유효한 주소값을 반환해야합니다. 만약 유저풀 메모리가 가득 찼다면 이 함수는 사용가능한 메모리 공간을 얻기 위해
+내보낼 수 있는 프레임이 하나도 없을 때만 NULL을 반환합니다. 만약 유저풀 메모리가 가득 찼다면 이 함수는 사용가능한 메모리 공간을 얻기 위해
 기존에 있던 프레임을 지워야합니다. */
 static struct frame *
 vm_get_frame (void) {
-	struct frame *frame = calloc(1, sizeof (struct frame));
-	ASSERT (frame != NULL);
+	struct thread *t = thread_current ();
+	struct frame *frame = NULL;
 
 	/* TODO: Fill this function. */
-	uint64_t *kva = palloc_get_page(PAL_USER);
+	lock_acquire (&frame_lock);
+	/* rss 한도에 닿은 프로세스는 남의 page 대신 자기 page부터 내보냄 */
+	if (rss_at_limit (t)) {
+		frame = vm_evict_frame (t);
+	}
 
-	if (kva == NULL) {		
-		struct frame *evicted_frame = vm_evict_frame(); //  evict 시킨 페이지에 상응하는 frame 리턴
-		ASSERT (evicted_frame != NULL);
-		kva = evicted_frame->kva; // evict 시킨 페이지의 kva에 공간 할당 받을 수 있음
+	if (frame == NULL) {
+		uint64_t *kva = palloc_get_page(PAL_USER);
+
+		if (kva == NULL) {
+			frame = vm_evict_frame(NULL); //  evict 시킨 페이지에 상응하는 frame 리턴 (kva 그대로 재사용)
+			if (frame == NULL) {
+				lock_release (&frame_lock);
+				return NULL;
+			}
+		} else {
+			frame = frame_of(kva);
+			ASSERT (frame->share_cnt == 0);
+			free_frames--;
+		}
 	}
-	frame->kva = kva;
 	ASSERT (frame->page == NULL);
 
-	list_push_back(&frame_table, &frame->frame_elem); // frame_table에 추가
+	/* 여유 frame이 low watermark 밑이면 daemon을 깨워 미리 비워 둠 */
+	if (free_frames < reclaim_low_wm && !reclaim_pending) {
+		reclaim_pending = true;
+		sema_up(&reclaim_sema);
+	}
+
+	/* frame->page는 내용이 다 채워진 뒤에 설정되므로 그 전까지는 evict되지 않음 */
+	frame->share_cnt = 1;
+	frame->accessed = true;
 	
 	frame->pml4 = thread_current()->pml4; // frame의 pml4에 현재 스레드의 pml4 초기화
+	lock_release (&frame_lock);
 
 	return frame;
 }
@@ -228,8 +969,8 @@ vm_stack_growth (void *addr) {
 	if (addr < USER_STACK_LIMIT){
 		goto err;
 	}
-	if (vm_alloc_page(VM_STACK, addr, true) && vm_claim_page(addr)) {
-		memset(addr, 0, PGSIZE);
+	/* frame은 fault handler가 읽기/쓰기에 맞춰 붙여 줌 */
+	if (vm_alloc_page(VM_STACK, addr, true)) {
 		return;
 	}
 
@@ -237,9 +978,70 @@ err :
 	PANIC("Stack growth failed!");
 }
 
+/*** haein ***/
 /* Handle the fault on write_protected page */
+/* COW로 공유 중인 page에 처음 write가 일어난 경우.
+ * 마지막으로 남은 page라면 frame을 그대로 가져가고, 아니라면 복사본을 만든다. */
 static bool
-vm_handle_wp (struct page *page UNUSED) {
+vm_handle_wp (struct page *page) {
+	struct thread *t = thread_current ();
+
+	lock_acquire (&frame_lock);
+	struct frame *old_frame = page->frame;
+	/* lock을 잡기 전에 evict됐거나 내보내는 중이라면 매핑이 지워졌으므로
+	 * 다시 fault가 나서 page를 읽어 옴 */
+	if (old_frame == NULL || old_frame->writeback) {
+		lock_release (&frame_lock);
+		return true;
+	}
+	if (old_frame != &zero_frame && old_frame->share_cnt == 1) {
+		/* Nobody else maps this frame anymore, take it over. */
+		old_frame->page = page;
+		old_frame->pml4 = t->pml4;
+		frame_charge (old_frame, t);
+		pml4_set_writable (t->pml4, page->va, true);
+		lock_release (&frame_lock);
+		return true;
+	}
+	/* 복사하는 동안 다른 mapper가 떠나면서 이 frame이 다시 evict 대상이
+	 * 되더라도 내용이 바뀌지 않도록 pin 해 둠 */
+	old_frame->pin_cnt++;
+	lock_release (&frame_lock);
+
+	struct frame *new_frame = vm_get_frame ();
+	if (new_frame == NULL) {
+		lock_acquire (&frame_lock);
+		old_frame->pin_cnt--;
+		lock_release (&frame_lock);
+		return false;
+	}
+	if (old_frame == &zero_frame) {
+		memset (new_frame->kva, 0, PGSIZE);
+	} else {
+		memcpy (new_frame->kva, old_frame->kva, PGSIZE);
+	}
+
+	/* Overwrite the read-only entry with the private copy. */
+	if (!pml4_set_page (t->pml4, page->va, new_frame->kva, page->writable)) {
+		lock_acquire (&frame_lock);
+		old_frame->pin_cnt--;
+		frame_unref (new_frame);
+		lock_release (&frame_lock);
+		return false;
+	}
+
+	lock_acquire (&frame_lock);
+	old_frame->pin_cnt--;
+	rmap_remove (old_frame, t->pml4, page->va);
+	frame_unref (old_frame);
+	page->frame = new_frame;
+	rmap_add (new_frame, t->pml4, page);
+	new_frame->page = page;
+	frame_charge (new_frame, t);
+	evict_insert (new_frame);
+	lock_release (&frame_lock);
+
+	return true;
 }
 
 
@@ -261,14 +1063,286 @@ vm_try_handle_fault (struct intr_frame *f UNUSED, void *addr,
 		rsp = t->rsp;
 	}
 
+	if (!not_present) {
+		/* Write on a present read-only page: copy-on-write, or a real violation. */
+		if (write && page != NULL && page->writable && page->frame != NULL) {
+			return vm_handle_wp (page);
+		}
+		return false;
+	}
+
 	if(page == NULL){
 		if ((addr == rsp - 8 || (rsp<=addr && addr<USER_STACK) && rsp != NULL)) { // stack growth
 			vm_stack_growth(addr);
-			return true;
+			page = spt_find_page(&t->spt, addr);
+		} else {
+			return false;
 		}
+	}
+
+	/* 내보내는 중인 page라면 다 쓴 뒤에 다시 읽어 옴 */
+	vm_wait_writeback (page);
+
+	/* 아직 아무도 쓰지 않은 0 page를 읽기만 하면 공용 zero frame을 읽기 전용으로 붙임 */
+	if (!write && vm_is_demand_zero (page)) {
+		return vm_map_zero_page (page);
+	}
+	if (!vm_do_claim_page (page)) {
 		return false;
 	}
-	return vm_do_claim_page (page);
+	vm_fault_around (page);
+	return true;
+}
+
+/*** haein ***/
+/* PAGE of an mmap or ELF segment region has just been faulted in. Also
+ * load the untouched pages of the same region within the aligned window
+ * of FAULT_AROUND_PAGES pages around it, so a sequential scan takes one
+ * fault per window instead of one per page. Only free frames are used:
+ * fault-around never evicts, and stops as soon as memory runs low.
+ * MADV_RANDOM regions get no fault-around; MADV_SEQUENTIAL ones get a
+ * doubled window and age the window behind the fault. */
+static void
+vm_fault_around (struct page *page) {
+	struct thread *t = thread_current ();
+	struct vm_region *region = vm_region_find (&t->spt, page->va);
+
+	if (region == NULL || region->advice == VM_ADV_RANDOM) {
+		return;
+	}
+
+	uint64_t window = FAULT_AROUND_PAGES * PGSIZE;
+	if (region->advice == VM_ADV_SEQUENTIAL) {
+		window *= 2;
+	}
+	uint8_t *start = (uint8_t *) ((uint64_t) page->va & ~(window - 1));
+	uint8_t *end = start + window;
+
+	/* 순차 접근이면 지나간 window는 다시 안 읽을 테니 accessed bit를 지워 먼저 evict되게 함 */
+	if (region->advice == VM_ADV_SEQUENTIAL && start - window >= (uint8_t *) region->start) {
+		for (uint8_t *va = start - window; va < start; va += PGSIZE) {
+			if (pml4_get_page (t->pml4, va) != NULL) {
+				pml4_set_accessed (t->pml4, va, false);
+			}
+		}
+	}
+	if (start < (uint8_t *) region->start) {
+		start = region->start;
+	}
+	if (end > (uint8_t *) region->end) {
+		end = region->end;
+	}
+	/* 파일 내용이 끝난 뒤의 page는 0 page이므로 fault 때 zero frame으로 처리 */
+	if (end > (uint8_t *) region->start + ROUND_UP (region->file_bytes, PGSIZE)) {
+		end = (uint8_t *) region->start + ROUND_UP (region->file_bytes, PGSIZE);
+	}
+
+	/* 파일 offset 순서대로 읽도록 앞에서부터 채움 */
+	for (uint8_t *va = start; va < end; va += PGSIZE) {
+		if (va == page->va || page_lookup (&t->spt, va) != NULL) {
+			continue;
+		}
+		/* lock 없이 읽지만 힌트로만 씀. 한도에 닿았으면 자기 page를 내보내면서까지 읽지 않음 */
+		if (free_frames <= reclaim_low_wm || rss_at_limit (t)) {
+			break;
+		}
+
+		struct page *around = vm_region_fault_in (&t->spt, region, va);
+		if (around == NULL || !vm_do_claim_page (around)) {
+			break;
+		}
+	}
+}
+
+/*** haein ***/
+/* Limit the current process to LIMIT resident pages (0 for no limit).
+ * Pages over a lowered limit are evicted right away, coldest first;
+ * after that every fault at the limit replaces one of the process's own
+ * pages instead of taking a frame from someone else. */
+void
+vm_set_rss_limit (size_t limit) {
+	struct thread *t = thread_current ();
+
+	lock_acquire (&frame_lock);
+	t->rss_limit = limit;
+	while (limit != 0 && t->rss > limit) {
+		size_t rss = t->rss;
+		struct frame *victim = vm_evict_frame (t);
+
+		/* writeback thread에 넘긴 page는 이미 rss에서 빠져 있음 */
+		if (victim != NULL) {
+			frame_unref (victim);
+		} else if (t->rss == rss) {
+			break;
+		}
+	}
+	lock_release (&frame_lock);
+}
+
+/*** haein ***/
+/* Apply ADVICE to the pages of the current process in [ADDR, ADDR +
+ * LENGTH). ADDR must be page-aligned. WILLNEED loads the pages that are
+ * not resident, as long as free frames remain. DONTNEED throws away the
+ * contents: region pages are reloaded from their file on the next touch
+ * (dirty mmap pages are written back first), other pages come back as
+ * zero pages. RANDOM and SEQUENTIAL are remembered per region and steer
+ * fault-around. Returns false if the range holds nothing mapped. */
+bool
+vm_madvise (void *addr, size_t length, enum vm_advice advice) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	uint8_t *end = (uint8_t *) addr + ROUND_UP (length, PGSIZE);
+	bool pattern = advice == VM_ADV_NORMAL || advice == VM_ADV_RANDOM
+			|| advice == VM_ADV_SEQUENTIAL;
+	bool mapped = false;
+	struct list_elem *e;
+
+	/* 범위와 겹치는 region만 잘라서 봄. 빈 주소 공간은 건너뜀 */
+	for (e = list_begin (&spt->regions); e != list_end (&spt->regions); e = list_next (e)) {
+		struct vm_region *region = list_entry (e, struct vm_region, elem);
+
+		if (region->end <= addr || (uint8_t *) region->start >= end) {
+			continue;
+		}
+		mapped = true;
+
+		/* 접근 패턴은 region 단위로 기억함 */
+		if (pattern) {
+			region->advice = advice;
+			continue;
+		}
+		if (!vm_advise_pages (spt, addr > region->start ? addr : region->start,
+					end < (uint8_t *) region->end ? end : region->end, advice, true)) {
+			return advice == VM_ADV_WILLNEED;
+		}
+	}
+
+	/* region 밖의 page는 stack뿐이라 stack이 자랄 수 있는 범위만 page 단위로 봄 */
+	uint8_t *lo = (uint8_t *) (USER_STACK_LIMIT);
+	uint8_t *hi = (uint8_t *) USER_STACK;
+	if ((uint8_t *) addr > lo) {
+		lo = addr;
+	}
+	if (end < hi) {
+		hi = end;
+	}
+	for (uint8_t *va = lo; va < hi; va += PGSIZE) {
+		if (page_lookup (spt, va) == NULL || vm_region_find (spt, va) != NULL) {
+			continue;
+		}
+		mapped = true;
+		if (!pattern && !vm_advise_pages (spt, va, va + PGSIZE, advice, false)) {
+			return advice == VM_ADV_WILLNEED;
+		}
+	}
+	return mapped;
+}
+
+/*** haein ***/
+/* Apply WILLNEED or DONTNEED to the pages in [START, END), which lie
+ * inside one region if IN_REGION and outside every region otherwise.
+ * Returns false when WILLNEED runs out of frames or DONTNEED fails. */
+static bool
+vm_advise_pages (struct supplemental_page_table *spt, uint8_t *start, uint8_t *end,
+		enum vm_advice advice, bool in_region) {
+	for (uint8_t *va = start; va < end; va += PGSIZE) {
+		if (advice == VM_ADV_WILLNEED) {
+			/* lock 없이 읽지만 힌트로만 씀 */
+			if (free_frames <= reclaim_low_wm || rss_at_limit (thread_current ())
+					|| !vm_prefetch_page (spt, va)) {
+				return false;
+			}
+		} else if (!vm_discard_page (spt, va, in_region)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*** haein ***/
+/* Load the page at VA unless it is already resident. */
+static bool
+vm_prefetch_page (struct supplemental_page_table *spt, void *va) {
+	struct page *page = spt_find_page (spt, va);
+
+	if (page == NULL) {
+		return false;
+	}
+	if (page->frame != NULL) {
+		return true;
+	}
+	return vm_do_claim_page (page);
+}
+
+/*** haein ***/
+/* Drop the page at VA together with its frame and swap slot. A page
+ * outside any region (!IN_REGION) is replaced by a fresh zero page of
+ * the same kind; region pages are rebuilt from the region on the next
+ * fault. */
+static bool
+vm_discard_page (struct supplemental_page_table *spt, void *va, bool in_region) {
+	struct page *page = page_lookup (spt, va);
+
+	/* 아직 만들어지지 않았거나 한 번도 읽지 않은 page는 버릴 내용이 없음 */
+	if (page == NULL || page->operations->type == VM_UNINIT) {
+		return true;
+	}
+
+	enum vm_type type = page_get_type (page);
+	bool writable = page->writable;
+	if (type == VM_ANON) {
+		type |= page->anon.aux_type;	/* stack 표시 유지 */
+	}
+	spt_remove_page (spt, page);
+
+	if (in_region) {
+		return true;
+	}
+	return vm_alloc_page (type, va, writable);
+}
+
+/*** haein ***/
+/* Returns true if PAGE has never been touched and its first contents are
+ * all zeros: an anonymous or stack page without an initializer, or a bss
+ * page of the executable that reads nothing from the file. */
+static bool
+vm_is_demand_zero (struct page *page) {
+	if (page->operations->type != VM_UNINIT
+			|| VM_TYPE (page->uninit.type) != VM_ANON) {
+		return false;
+	}
+	if (page->uninit.init == NULL) {
+		return true;
+	}
+
+	struct lazy_info *info = page->uninit.aux;
+	return page->uninit.type == VM_SEG && info->read_bytes == 0;
+}
+
+/*** haein ***/
+/* Map the shared zero frame read-only at PAGE's address. The page is
+ * turned into an anon page right away; its first write goes through
+ * vm_handle_wp, which hands it a private zero-filled frame. */
+static bool
+vm_map_zero_page (struct page *page) {
+	struct uninit_page *uninit = &page->uninit;
+
+	/* bss page는 파일에서 읽을 것이 없으므로 lazy_load_segment를 건너뜀 */
+	if (uninit->init != NULL) {
+		slab_free (&lazy_info_slab, uninit->aux);
+		uninit->init = NULL;
+		uninit->aux = NULL;
+	}
+
+	page->frame = &zero_frame;
+	if (!swap_in (page, zero_frame.kva)) {
+		page->frame = NULL;
+		return false;
+	}
+	if (!pml4_set_page (thread_current ()->pml4, page->va, zero_frame.kva, false)) {
+		page->frame = NULL;
+		return false;
+	}
+	return true;
 }
 
 /* Free the page.
@@ -276,7 +1350,107 @@ vm_try_handle_fault (struct intr_frame *f UNUSED, void *addr,
 void
 vm_dealloc_page (struct page *page) {
 	destroy (page);
-	free (page);
+	slab_free (&page_slab, page);
+}
+
+/*** haein ***/
+/* Detach PAGE from its frame and unmap it from the current address space.
+ * A frame shared by copy-on-write only loses one reference; the last user
+ * returns the frame to the user pool. */
+void
+vm_free_frame (struct page *page) {
+	/* 다른 스레드가 이 page를 evict하는 중일 수 있으므로 lock을 잡고 frame을 읽음 */
+	lock_acquire (&frame_lock);
+	while (page->frame != NULL && page->frame->writeback) {
+		cond_wait (&writeback_done, &frame_lock);
+	}
+	struct frame *frame = page->frame;
+
+	if (frame != NULL) {
+		/* pml4_destroy가 같은 kva를 다시 free하지 않도록 매핑을 지워줌 */
+		if (VM_TYPE (page->operations->type) != VM_PAGE_CACHE) {
+			pml4_clear_page (thread_current ()->pml4, page->va);
+			rmap_remove (frame, thread_current ()->pml4, page->va);
+		}
+		page->frame = NULL;
+		frame_unref (frame);
+	}
+	lock_release (&frame_lock);
+}
+
+/*** haein ***/
+/* If PAGE, a kernel-owned page that is not mapped in any address space,
+ * has its contents in a frame, pin that frame so it cannot be evicted
+ * until vm_unpin_page() and return true. Returns false if PAGE is not
+ * resident. Never takes a new frame, so it may be called with locks held
+ * that the writeback path also takes. */
+bool
+vm_pin_page (struct page *page) {
+	lock_acquire (&frame_lock);
+	struct frame *frame = page->frame;
+	if (frame != NULL) {
+		frame->pin_cnt++;
+		frame->accessed = true;
+	}
+	lock_release (&frame_lock);
+	return frame != NULL;
+}
+
+/*** haein ***/
+/* Returns an empty frame for vm_pin_page_in(), or NULL if nothing can be
+ * evicted. 얻는 동안 writeback을 기다릴 수 있으므로 writeback thread가
+ * 잡는 lock을 든 채로 부르면 안 됨 */
+struct frame *
+vm_reserve_frame (void) {
+	struct frame *frame = vm_get_frame ();
+
+	if (frame != NULL) {
+		frame->pml4 = NULL;
+	}
+	return frame;
+}
+
+/*** haein ***/
+/* Give back a frame from vm_reserve_frame() that was not used. */
+void
+vm_unreserve_frame (struct frame *frame) {
+	lock_acquire (&frame_lock);
+	frame_unref (frame);
+	lock_release (&frame_lock);
+}
+
+/*** haein ***/
+/* Read PAGE, a kernel-owned page that is not resident, into FRAME from
+ * vm_reserve_frame() and pin it as vm_pin_page() does. FRAME is used up
+ * either way. The caller must keep other threads from loading the same
+ * page concurrently. */
+bool
+vm_pin_page_in (struct page *page, struct frame *frame) {
+	page->frame = frame;
+	if (!swap_in (page, frame->kva)) {
+		lock_acquire (&frame_lock);
+		page->frame = NULL;
+		frame_unref (frame);
+		lock_release (&frame_lock);
+		return false;
+	}
+
+	lock_acquire (&frame_lock);
+	frame->pin_cnt++;
+	frame->page = page;
+	evict_insert (frame);
+	lock_release (&frame_lock);
+	return true;
+}
+
+/*** haein ***/
+/* Release a pin taken by vm_pin_page(). */
+void
+vm_unpin_page (struct page *page) {
+	lock_acquire (&frame_lock);
+	ASSERT (page->frame != NULL && page->frame->pin_cnt > 0);
+	page->frame->pin_cnt--;
+	lock_release (&frame_lock);
 }
 
 /*** Dongdongbro ***/
@@ -298,20 +1472,419 @@ vm_claim_page (void *va) {
 /* 페이지 값을 넘겨 받고, 그 페이지와 get frame에서 물리 메모리 공간을 페이지와 연결 시켜준다. */
 static bool
 vm_do_claim_page (struct page *page) { // 이미 만들어진 page => 매핑
+	return vm_do_claim_page_in (page, thread_current ()->pml4);
+}
+
+/*** haein ***/
+/* Claim the PAGE into the address space of PML4, which need not be the
+ * current one (e.g. the parent's, while the child is forking). */
+static bool
+vm_do_claim_page_in (struct page *page, uint64_t *pml4) {
+	struct shared_text key;
+	bool text = vm_text_key (page, pml4, &key);
+	bool file = !text && vm_file_key (page, pml4, &key);
+
+	/* 다른 프로세스가 이미 읽어 둔 코드 page가 있으면 그 frame을 그대로 씀 */
+	if (text && vm_share_text (page, &key)) {
+		return true;
+	}
+	/* 파일 page도 누군가 올려 둔 frame이 있으면 그것을 매핑함 */
+	if (file && vm_share_file (page, &key)) {
+		return true;
+	}
+
 	struct frame *frame = vm_get_frame ();
-	struct thread *t = thread_current();
+	if (frame == NULL) {
+		return false;
+	}
+	/* 이미 한 번 올라왔던 page라면 evict됐다가 돌아온 것 */
+	bool refault = page->operations->type != VM_UNINIT;
+	/* 초기화 함수가 없는 anon page는 여기서 한 번만 0으로 채움 */
+	bool zero_fill = page->operations->type == VM_UNINIT
+			&& VM_TYPE (page->uninit.type) == VM_ANON && page->uninit.init == NULL;
 
 	/* Set links */
-	frame->page = page;
+	frame->pml4 = pml4;
 	page->frame = frame;
 
 	/* TODO: Insert page table entry to map page's VA to frame's PA. */
-	if (pml4_get_page (t->pml4, page->va) == NULL && pml4_set_page(t->pml4, page->va, frame->kva, page->writable)) { /*** 고민 필요!!! - true? ***/
-		return swap_in (page, frame->kva); // page fault가 일어났을 때 swap in
-	} else { // 만약 page fault에서 호출했는데 실패했으면 바로 프로세스 종료
-		// 나중에 vm_dealloc_page 써야 할듯? /*** GriiledSalmon ***/
+	if (pml4_get_page (pml4, page->va) != NULL
+			|| !pml4_set_page (pml4, page->va, frame->kva, page->writable)) {
+		goto err;
+	}
+	if (!swap_in (page, frame->kva)) { // page fault가 일어났을 때 swap in
+		pml4_clear_page (pml4, page->va);
+		goto err;
+	}
+	if (zero_fill) {
+		memset (frame->kva, 0, PGSIZE);
+	}
+
+	/* 내용이 다 채워진 뒤에야 evict 대상이 됨 */
+	lock_acquire (&frame_lock);
+	rmap_add (frame, pml4, page);
+	frame->page = page;
+	/* fork 중 부모 주소 공간에 올린 frame은 곧바로 공유되므로 세지 않음 */
+	if (pml4 == thread_current ()->pml4) {
+		frame_charge (frame, thread_current ());
+	}
+	evict_insert (frame);
+	evict_note_fault (refault);
+	if (text || file) {
+		vm_publish_text (frame, &key);
+	}
+	lock_release (&frame_lock);
+	return true;
+
+err:
+	/* 아직 아무에게도 보이지 않은 frame이므로 바로 돌려줌 */
+	lock_acquire (&frame_lock);
+	page->frame = NULL;
+	frame_unref (frame);
+	lock_release (&frame_lock);
+	return false;
+}
+
+/*** haein ***/
+/* If PAGE is a not-yet-loaded read-only page of the running executable
+ * being claimed into the current address space, fill KEY with the part of
+ * the file it holds and return true. */
+static bool
+vm_text_key (struct page *page, uint64_t *pml4, struct shared_text *key) {
+	struct thread *t = thread_current ();
+
+	if (page->operations->type != VM_UNINIT || page->uninit.type != VM_SEG
+			|| page->writable || pml4 != t->pml4 || t->running == NULL) {
 		return false;
 	}
+
+	struct lazy_info *info = page->uninit.aux;
+	key->inode = file_get_inode (t->running);
+	key->ofs = info->ofs;
+	key->read_bytes = info->read_bytes;
+	key->table = &text_table;
+	return true;
+}
+
+/*** haein ***/
+/* If PAGE is a page of a file mapping being claimed into the current
+ * address space, fill KEY with the part of the file it holds and return
+ * true. Pages that lie wholly past the end of the file are not shared. */
+static bool
+vm_file_key (struct page *page, uint64_t *pml4, struct shared_text *key) {
+	struct file *file;
+
+	if (pml4 != thread_current ()->pml4) {
+		return false;
+	}
+	if (page->operations->type == VM_UNINIT && VM_TYPE (page->uninit.type) == VM_FILE) {
+		struct lazy_info *info = page->uninit.aux;
+		file = info->file;
+		key->ofs = info->ofs;
+		key->read_bytes = info->read_bytes;
+	} else if (page->operations->type == VM_FILE) {
+		file = page->file.file;
+		key->ofs = page->file.ofs;
+		key->read_bytes = page->file.read_bytes;
+	} else {
+		return false;
+	}
+	if (key->read_bytes == 0) {
+		return false;
+	}
+	key->inode = file_get_inode (file);
+	key->table = &file_table;
+	return true;
+}
+
+/*** haein ***/
+/* Map the frame already holding KEY at PAGE with PAGE's own permission,
+ * without reading the file. Returns false if no page of that part of the
+ * file is resident, or if it was mapped with a different length. */
+static bool
+vm_share_file (struct page *page, struct shared_text *key) {
+	lock_acquire (&frame_lock);
+	struct hash_elem *e = hash_find (&file_table, &key->elem);
+	if (e == NULL || hash_entry (e, struct shared_text, elem)->read_bytes != key->read_bytes) {
+		lock_release (&frame_lock);
+		return false;
+	}
+
+	/* 여러 page가 매핑하는 동안은 주인이 없음. rmap에 들어갈 때까지 pin */
+	struct frame *frame = hash_entry (e, struct shared_text, elem)->frame;
+	frame->share_cnt++;
+	frame->pin_cnt++;
+	frame_uncharge (frame);
+	frame->page = NULL;
+	lock_release (&frame_lock);
+
+	/* uninit page는 lazy_load_file 없이 file page로만 바꿔 줌.
+	 * evict됐던 file page는 다시 읽으면 다른 mapper의 write를 덮어쓰므로 그대로 둠 */
+	page->frame = frame;
+	if (page->operations->type == VM_UNINIT) {
+		struct lazy_info *info = page->uninit.aux;
+
+		page->uninit.init = NULL;
+		if (!swap_in (page, frame->kva)) {
+			lock_acquire (&frame_lock);
+			page->frame = NULL;
+			frame->pin_cnt--;
+			frame_unref (frame);
+			lock_release (&frame_lock);
+			return false;
+		}
+		slab_free (&lazy_info_slab, info);
+	}
+
+	if (!pml4_set_page (thread_current ()->pml4, page->va, frame->kva, page->writable)) {
+		lock_acquire (&frame_lock);
+		page->frame = NULL;
+		frame->pin_cnt--;
+		frame_unref (frame);
+		lock_release (&frame_lock);
+		return false;
+	}
+
+	lock_acquire (&frame_lock);
+	rmap_add (frame, thread_current ()->pml4, page);
+	frame->pin_cnt--;
+	lock_release (&frame_lock);
+	return true;
+}
+
+/*** haein ***/
+/* Returns true if a fault on the same address of a child will reach
+ * the contents of PAGE, a file page of the parent, on its own: PAGE is
+ * not resident (so the file is up to date) or its frame is in
+ * file_table. Then fork need not copy PAGE. */
+static bool
+vm_file_fault_shares (struct page *page) {
+	vm_wait_writeback (page);
+
+	lock_acquire (&frame_lock);
+	struct frame *frame = page->frame;
+	bool shares = frame == NULL
+			|| (frame->text != NULL && frame->text->table == &file_table);
+	lock_release (&frame_lock);
+	return shares;
+}
+
+/*** haein ***/
+/* Returns the frame holding page offset OFS of INODE for file mappings,
+ * or NULL, and stores how many of its bytes come from the file in
+ * *READ_BYTES. Must hold frame_lock. */
+static struct frame *
+vm_file_lookup (struct inode *inode, off_t ofs, size_t *read_bytes) {
+	struct shared_text key;
+
+	key.inode = inode;
+	key.ofs = ofs;
+	struct hash_elem *e = hash_find (&file_table, &key.elem);
+	if (e == NULL) {
+		return NULL;
+	}
+	*read_bytes = hash_entry (e, struct shared_text, elem)->read_bytes;
+	return hash_entry (e, struct shared_text, elem)->frame;
+}
+
+/*** haein ***/
+/* File data from OFS was just read into the SIZE bytes of user memory at
+ * BUF. Replace the parts that are mapped in some process with the mapped
+ * frame, which may hold writes not yet written back. */
+void
+vm_mapped_read (struct inode *inode, off_t ofs, void *buf, size_t size) {
+	uint8_t *bounce = NULL;
+
+	/* lock 없이 읽지만 비어 있는지만 보는 힌트 */
+	if (hash_empty (&file_table)) {
+		return;
+	}
+
+	for (size_t done = 0; done < size; ) {
+		off_t page_ofs = ROUND_DOWN (ofs + done, PGSIZE);
+		size_t in_page = ofs + done - page_ofs;
+		size_t chunk = PGSIZE - in_page < size - done ? PGSIZE - in_page : size - done;
+		size_t read_bytes, n = 0;
+
+		/* user memory는 fault가 날 수 있으므로 frame_lock을 놓은 뒤에 복사 */
+		lock_acquire (&frame_lock);
+		struct frame *frame = vm_file_lookup (inode, page_ofs, &read_bytes);
+		if (frame != NULL && in_page < read_bytes
+				&& (bounce != NULL || (bounce = palloc_get_page (0)) != NULL)) {
+			n = read_bytes - in_page < chunk ? read_bytes - in_page : chunk;
+			memcpy (bounce, (uint8_t *) frame->kva + in_page, n);
+		}
+		lock_release (&frame_lock);
+
+		memcpy ((uint8_t *) buf + done, bounce, n);
+		done += chunk;
+	}
+	palloc_free_page (bounce);
+}
+
+/*** haein ***/
+/* The SIZE bytes at BUF were just written to the file at OFS. Copy them
+ * into the frames that map those parts of the file as well, so mappers
+ * see the write and a later writeback does not undo it. */
+void
+vm_mapped_write (struct inode *inode, off_t ofs, const void *buf, size_t size) {
+	uint8_t *bounce;
+
+	if (hash_empty (&file_table) || (bounce = palloc_get_page (0)) == NULL) {
+		return;
+	}
+
+	for (size_t done = 0; done < size; ) {
+		off_t page_ofs = ROUND_DOWN (ofs + done, PGSIZE);
+		size_t in_page = ofs + done - page_ofs;
+		size_t chunk = PGSIZE - in_page < size - done ? PGSIZE - in_page : size - done;
+		size_t read_bytes;
+
+		memcpy (bounce, (const uint8_t *) buf + done, chunk);
+
+		lock_acquire (&frame_lock);
+		struct frame *frame = vm_file_lookup (inode, page_ofs, &read_bytes);
+		if (frame != NULL && in_page < read_bytes) {
+			size_t n = read_bytes - in_page < chunk ? read_bytes - in_page : chunk;
+			memcpy ((uint8_t *) frame->kva + in_page, bounce, n);
+		}
+		lock_release (&frame_lock);
+		done += chunk;
+	}
+	palloc_free_page (bounce);
+}
+
+/*** haein ***/
+/* Map the frame already holding KEY read-only at PAGE, without reading the
+ * executable. Returns false if no process has that part loaded. */
+static bool
+vm_share_text (struct page *page, struct shared_text *key) {
+	lock_acquire (&frame_lock);
+	struct hash_elem *e = hash_find (&text_table, &key->elem);
+	if (e == NULL) {
+		lock_release (&frame_lock);
+		return false;
+	}
+
+	/* 공유 중인 frame은 COW처럼 주인이 없음. rmap에 들어갈 때까지 pin */
+	struct frame *frame = hash_entry (e, struct shared_text, elem)->frame;
+	frame->share_cnt++;
+	frame->pin_cnt++;
+	frame_uncharge (frame);
+	frame->page = NULL;
+	lock_release (&frame_lock);
+
+	/* 실패하면 다음 fault에서 파일을 읽도록 uninit page 그대로 되돌려 놓음 */
+	const struct page_operations *ops = page->operations;
+	struct uninit_page uninit = page->uninit;
+
+	page->frame = frame;
+	if (!pml4_set_page (thread_current ()->pml4, page->va, frame->kva, false)) {
+		goto err;
+	}
+	/* lazy_load_segment를 건너뛰고 anon page로만 바꿔 줌 */
+	page->uninit.init = NULL;
+	page->uninit.aux = NULL;
+	if (!swap_in (page, frame->kva)) {
+		pml4_clear_page (thread_current ()->pml4, page->va);
+		page->operations = ops;
+		page->uninit = uninit;
+		goto err;
+	}
+	slab_free (&lazy_info_slab, uninit.aux);
+
+	lock_acquire (&frame_lock);
+	rmap_add (frame, thread_current ()->pml4, page);
+	frame->pin_cnt--;
+	lock_release (&frame_lock);
+	return true;
+
+err:
+	lock_acquire (&frame_lock);
+	page->frame = NULL;
+	frame->pin_cnt--;
+	frame_unref (frame);
+	lock_release (&frame_lock);
+	return false;
+}
+
+/*** haein ***/
+/* Record that FRAME now holds KEY so later processes can share it.
+ * Must hold frame_lock. */
+static void
+vm_publish_text (struct frame *frame, struct shared_text *key) {
+	ASSERT (lock_held_by_current_thread (&frame_lock));
+
+	/* 동시에 읽어 온 프로세스가 먼저 등록했다면 이 frame은 그냥 혼자 씀 */
+	if (hash_find (key->table, &key->elem) != NULL) {
+		return;
+	}
+
+	struct shared_text *text = malloc (sizeof *text);
+	if (text == NULL) {
+		return;
+	}
+	*text = *key;
+	text->frame = frame;
+	frame->text = text;
+	hash_insert (text->table, &text->elem);
+}
+
+/*** haein ***/
+/* FRAME is being freed or evicted: it no longer holds its text page.
+ * Must hold frame_lock. */
+static void
+frame_forget_text (struct frame *frame) {
+	if (frame->text == NULL) {
+		return;
+	}
+	hash_delete (frame->text->table, &frame->text->elem);
+	free (frame->text);
+	frame->text = NULL;
+}
+
+/*** haein ***/
+static uint64_t
+text_hash (const struct hash_elem *e, void *aux UNUSED) {
+	const struct shared_text *text = hash_entry (e, struct shared_text, elem);
+
+	return hash_bytes (&text->inode, sizeof text->inode)
+		^ hash_int (text->ofs) ^ hash_int (text->read_bytes);
+}
+
+/*** haein ***/
+static bool
+text_less (const struct hash_elem *a_, const struct hash_elem *b_, void *aux UNUSED) {
+	const struct shared_text *a = hash_entry (a_, struct shared_text, elem);
+	const struct shared_text *b = hash_entry (b_, struct shared_text, elem);
+
+	if (a->inode != b->inode) {
+		return a->inode < b->inode;
+	}
+	if (a->ofs != b->ofs) {
+		return a->ofs < b->ofs;
+	}
+	return a->read_bytes < b->read_bytes;
+}
+
+/*** haein ***/
+static uint64_t
+file_key_hash (const struct hash_elem *e, void *aux UNUSED) {
+	const struct shared_text *key = hash_entry (e, struct shared_text, elem);
+
+	return hash_bytes (&key->inode, sizeof key->inode) ^ hash_int (key->ofs);
+}
+
+/*** haein ***/
+static bool
+file_key_less (const struct hash_elem *a_, const struct hash_elem *b_, void *aux UNUSED) {
+	const struct shared_text *a = hash_entry (a_, struct shared_text, elem);
+	const struct shared_text *b = hash_entry (b_, struct shared_text, elem);
+
+	if (a->inode != b->inode) {
+		return a->inode < b->inode;
+	}
+	return a->ofs < b->ofs;
 }
 
 /*** Dongdongbro ***/
@@ -329,52 +1902,106 @@ supplemental_page_table_init (struct supplemental_page_table *spt) {
 	if (!hash_init(&spt->h, page_hash, page_less, NULL)){
 		PANIC("There are no memory in Kernel pool(malloc fail)");
 	}
+	list_init(&spt->regions);
+	spt->region_hint = NULL;
+	spt->owner = thread_current ();
+	memset (spt->cache, 0, sizeof spt->cache);
+	spt->heap_start = NULL;
+	spt->brk = NULL;
+	spt->heap = NULL;
 }
 
-/*** GrilledSalmon ***/
-/* Checking the condition, copy file struct from parent to child. */
-static void copy_parent_file (struct file *parent_file, int parent_remain_cnt, tid_t child_tid, bool is_uninit, void *aux) {
-	if (is_uninit) {
-		struct lazy_info *lazy_info = aux;
-		if (parent_file->copying_child != child_tid) { 	/* First file copy condition */
-			lazy_info->file = file_reopen(parent_file);
-			lazy_info->remain_cnt = malloc(sizeof(int));
-
-			memcpy(lazy_info->file, parent_file, sizeof(struct file));
-			*lazy_info->remain_cnt = parent_remain_cnt;
-
-			parent_file->copying_child = child_tid;
-			parent_file->child_file = lazy_info->file;
-			parent_file->child_remain_cnt = lazy_info->remain_cnt;
-		} else {
-			lazy_info->file = parent_file->child_file;
-			lazy_info->remain_cnt = parent_file->child_remain_cnt;
+/*** haein ***/
+/* Map the frame of SRC_PAGE (owned by PARENT) into DST_PAGE read-only and
+ * write-protect the parent's entry as well. The first write on either side
+ * faults into vm_handle_wp, which makes the private copy. */
+static bool
+vm_share_frame (struct page *dst_page, struct page *src_page, struct thread *parent) {
+	struct frame *frame;
+
+	/* 부모 page가 자리에 있는 것을 frame_lock 안에서 확인해야 함. 그 사이에
+	 * evict됐다면 다시 올림 */
+	for (;;) {
+		vm_wait_writeback (src_page);
+
+		/* swap out 된 부모 page는 먼저 부모 주소 공간에 다시 올려줌 */
+		if (src_page->frame == NULL && !vm_do_claim_page_in (src_page, parent->pml4)) {
+			return false;
 		}
-	} else {
-		struct file_page *file_page = aux;
-		if (parent_file->copying_child != child_tid) { 	/* First file copy condition */
-			file_page->file = file_reopen(parent_file);
-			file_page->remain_cnt = malloc(sizeof(int));
 
-			memcpy(file_page->file, parent_file, sizeof(struct file));
-			*file_page->remain_cnt = parent_remain_cnt;
+		lock_acquire (&frame_lock);
+		frame = src_page->frame;
+		if (frame != NULL && !frame->writeback) {
+			break;
+		}
+		lock_release (&frame_lock);
+	}
 
-			parent_file->copying_child = child_tid;
-			parent_file->child_file = file_page->file;
-			parent_file->child_remain_cnt = file_page->remain_cnt;
-		} else {
-			file_page->file = parent_file->child_file;
-			file_page->remain_cnt = parent_file->child_remain_cnt;
+	/* A shared frame has no single owner until it is written. 자식의 매핑이
+	 * rmap에 들어갈 때까지는 pin으로 evict를 막음 */
+	if (frame != &zero_frame) {
+		frame_uncharge (frame);
+		frame->page = NULL;
+		frame->share_cnt++;
+		frame->pin_cnt++;
+	}
+	pml4_set_writable (parent->pml4, src_page->va, false);
+	lock_release (&frame_lock);
+
+	/* uninit 상태의 dst_page를 디스크를 읽지 않고 anon/file page로 바꿔줌 */
+	dst_page->frame = frame;
+	if (!swap_in (dst_page, frame->kva)
+			|| !pml4_set_page (thread_current ()->pml4, dst_page->va, frame->kva, false)) {
+		lock_acquire (&frame_lock);
+		dst_page->frame = NULL;
+		if (frame != &zero_frame) {
+			frame->pin_cnt--;
+			frame_unref (frame);
 		}
+		lock_release (&frame_lock);
+		return false;
+	}
+
+	if (frame != &zero_frame) {
+		lock_acquire (&frame_lock);
+		rmap_add (frame, thread_current ()->pml4, dst_page);
+		frame->pin_cnt--;
+		lock_release (&frame_lock);
 	}
+	return true;
 }
 
-/*** Dongdongbro & GrilledSalmon ***/
+/*** Dongdongbro & GrilledSalmon & haein ***/
 /* Copy supplemental page table from src to dst */
 bool
 supplemental_page_table_copy (struct supplemental_page_table *dst, struct supplemental_page_table *src) {
-	tid_t tid = thread_current()->tid;
+	struct thread *parent = src->owner;
 	struct hash_iterator i;
+	struct list_elem *e;
+
+	/* region은 그대로 복사하고, mmap 파일은 자식 몫으로 새로 엶 */
+	for (e = list_begin (&src->regions); e != list_end (&src->regions); e = list_next (e)) {
+		struct vm_region *region = list_entry (e, struct vm_region, elem);
+		struct file *file = NULL;
+
+		if (region->file != NULL && (file = file_reopen (region->file)) == NULL) {
+			return false;
+		}
+		struct vm_region *copy = vm_region_add (dst, region->start,
+				(uint8_t *) region->end - (uint8_t *) region->start, region->type,
+				region->writable, region->init, file, region->ofs, region->file_bytes);
+		if (copy == NULL) {
+			file_close (file);
+			return false;
+		}
+		copy->advice = region->advice;
+		if (region == src->heap) {
+			dst->heap = copy;
+		}
+	}
+	dst->heap_start = src->heap_start;
+	dst->brk = src->brk;
+
 	hash_first (&i, &src->h);
 	while (hash_next(&i)){
 		struct page *src_page = hash_entry(hash_cur(&i), struct page, hash_elem);
@@ -386,11 +2013,16 @@ supplemental_page_table_copy (struct supplemental_page_table *dst, struct supple
 		{
 		case VM_UNINIT :
 		{
+			/* region의 page라면 자식이 처음 접근할 때 다시 만들면 됨 */
+			if (vm_region_find (dst, src_page->va) != NULL) {
+				break;
+			}
+
 			struct lazy_info *src_lazy_info = src_page->uninit.aux;
-			dst_lazy_info = malloc(sizeof(struct lazy_info));
-			memcpy(dst_lazy_info, src_lazy_info, sizeof(struct lazy_info));
-			if (src_page->uninit.type == VM_FILE) {
-				copy_parent_file(src_lazy_info->file, *src_lazy_info->remain_cnt, tid, true, dst_lazy_info);
+			dst_lazy_info = NULL;
+			if (src_lazy_info != NULL) {
+				dst_lazy_info = slab_alloc(&lazy_info_slab);
+				memcpy(dst_lazy_info, src_lazy_info, sizeof(struct lazy_info));
 			}
 
 			if(!vm_alloc_page_with_initializer(src_page->uninit.type, src_page->va, src_page->writable, src_page->uninit.init, dst_lazy_info)){
@@ -401,23 +2033,33 @@ supplemental_page_table_copy (struct supplemental_page_table *dst, struct supple
 
 		case VM_ANON :
 		{	
-			if(!vm_alloc_page(type | src_page->anon.aux_type, src_page->va, src_page->writable) || !vm_claim_page(src_page->va)){
+			if(!vm_alloc_page(type | src_page->anon.aux_type, src_page->va, src_page->writable)){
 				return false;
 			};
 			dst_page = spt_find_page(dst, src_page->va);
-			memcpy(dst_page->frame->kva, src_page->frame->kva, PGSIZE);
+			if (!vm_share_frame(dst_page, src_page, parent)) {
+				return false;
+			}
 		}
 			break;
 
 		case VM_FILE :
 		{
-			if(!vm_alloc_page_with_initializer(type, src_page->va, src_page->writable, NULL, &src_page->file) || !vm_claim_page(src_page->va)){
+			/* 자식도 region을 통해 fault 때 같은 frame(또는 파일)을 매핑함 */
+			if (vm_file_fault_shares (src_page)) {
+				break;
+			}
+			if(!vm_alloc_page_with_initializer(type, src_page->va, src_page->writable, NULL, &src_page->file)){
 				return false;
 			};
 			dst_page = spt_find_page(dst, src_page->va);
-			memcpy(dst_page->frame->kva, src_page->frame->kva, PGSIZE);
-			/*** 부모의 dirty bit를 복사해줘야 할까? 고민 필요!!!!! ***/
-			copy_parent_file(src_page->file.file, *src_page->file.remain_cnt, tid, false, &dst_page->file);
+			if (!vm_share_frame(dst_page, src_page, parent)) {
+				return false;
+			}
+			/* 부모의 dirty bit는 부모 pte에 남아 있으므로 writeback은 부모가 담당.
+			 * 자식 page는 자식 region의 파일을 씀 */
+			dst_page->file.region = vm_region_find (dst, src_page->va);
+			dst_page->file.file = dst_page->file.region->file;
 			break;
 		}
 
@@ -444,21 +2086,55 @@ supplemental_page_table_kill (struct supplemental_page_table *spt) {
 	/* TODO: Destroy all the supplemental_page_table hold by thread and
 	 * TODO: writeback all the modified contents to the storage. */
 
+	/* mmap의 dirty page는 파일 offset 순으로 묶어서 한 번에 내려씀 */
+	struct list_elem *e;
+	for (e = list_begin (&spt->regions); e != list_end (&spt->regions); e = list_next (e)) {
+		struct vm_region *region = list_entry (e, struct vm_region, elem);
+		if (region->type == VM_FILE) {
+			file_region_writeback (region, region->start, region->end);
+		}
+	}
+
 	hash_destroy(&spt->h, spt_hash_destructor);
+	memset (spt->cache, 0, sizeof spt->cache);
+
+	/* frame을 모두 돌려준 뒤라 이 주소 공간의 ghost는 더 생기지 않음 */
+	lock_acquire (&frame_lock);
+	evict_forget (spt->owner->pml4);
+	lock_release (&frame_lock);
+
+	/* page들의 writeback이 끝난 뒤에 region과 파일을 정리 */
+	spt->region_hint = NULL;
+	while (!list_empty (&spt->regions)) {
+		struct vm_region *region = list_entry (list_pop_front (&spt->regions), struct vm_region, elem);
+		file_close (region->file);
+		slab_free (&region_slab, region);
+	}
 }
 
 
 /*** haein ***/
-/* Returns the page containing the given virtual address, or a null pointer if no such page exists. */
+/* Returns the page containing the given virtual address, or a null pointer if no such page exists.
+ * Hits are remembered in SPT's small direct-mapped cache in front of the hash. */
 struct page *
-page_lookup (struct hash *h, const void *va) {
+page_lookup (struct supplemental_page_table *spt, const void *va) {
   struct page p;
   struct hash_elem *e;
 
   p.va = pg_round_down(va); // offset을 0으로 만들고 페이지 주소를 받아옴
 
-  e = hash_find (h, &p.hash_elem);
-  return e != NULL ? hash_entry (e, struct page, hash_elem) : NULL;
+  /* 같은 buffer를 반복해서 검사하는 system call은 대부분 여기서 끝남 */
+  struct page **slot = &spt->cache[SPT_CACHE_SLOT (p.va)];
+  if (*slot != NULL && (*slot)->va == p.va) {
+    return *slot;
+  }
+
+  e = hash_find (&spt->h, &p.hash_elem);
+  if (e == NULL) {
+    return NULL;
+  }
+  *slot = hash_entry (e, struct page, hash_elem);
+  return *slot;
 }
 
 /*** Dongdongbro ***/
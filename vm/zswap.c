@@ -0,0 +1,234 @@
+/* zswap.c: Compressed in-RAM tier in front of the swap disk. */
+
+#include "vm/zswap.h"
+#include "vm/vm.h"
+#include <bitmap.h>
+#include <round.h>
+#include <string.h>
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+
+/* Evicted anon page들을 압축해서 kernel pool의 arena에 담아 둠.
+ * arena가 차 있거나 잘 압축되지 않는 page만 swap disk로 감. */
+
+#define ZSWAP_ARENA_PAGES 64			/* arena 크기 (page) */
+#define ZSWAP_CHUNK 64					/* arena 할당 단위 (byte) */
+#define ZSWAP_MAX_LEN (PGSIZE * 3 / 4)	/* 이보다 크게 압축되면 disk로 */
+
+/* 압축 형식: control byte 하나 뒤에
+ *   c < 0x80: literal c + 1개
+ *   c >= 0x80: (c & 0x7f) + LZ_MIN_MATCH 바이트를 offset(2 byte, LE) 앞에서 복사 */
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_MATCH (0x7f + LZ_MIN_MATCH)
+#define LZ_MAX_LITERAL 0x80
+#define LZ_HASH_BITS 11
+
+static uint8_t *arena;					/* ZSWAP_ARENA_PAGES page, 없으면 NULL */
+static struct bitmap *arena_map;		/* chunk별 사용 여부 */
+static struct lock zswap_lock;			/* arena, arena_map, 아래 작업 공간 보호 */
+static uint8_t scratch[ZSWAP_MAX_LEN];	/* 압축 결과를 잠시 담는 곳 */
+static uint16_t lz_table[1 << LZ_HASH_BITS];	/* 4 byte hash -> 위치 + 1 */
+
+static size_t lz_compress (const uint8_t *src, uint8_t *dst, size_t limit);
+static bool lz_decompress (const uint8_t *src, size_t len, uint8_t *dst);
+static bool page_is_zero (const void *kva);
+
+/*** haein ***/
+/* Set up the arena. Without kernel memory to spare, zswap stays off and
+ * every page goes to the swap disk. */
+void
+zswap_init (void) {
+	lock_init (&zswap_lock);
+	arena = palloc_get_multiple (0, ZSWAP_ARENA_PAGES);
+	if (arena == NULL) {
+		return;
+	}
+	arena_map = bitmap_create (ZSWAP_ARENA_PAGES * PGSIZE / ZSWAP_CHUNK);
+	if (arena_map == NULL) {
+		palloc_free_multiple (arena, ZSWAP_ARENA_PAGES);
+		arena = NULL;
+	}
+}
+
+/*** haein ***/
+/* Try to keep the page at KVA compressed in RAM on behalf of ANON_PAGE.
+ * Returns false if it compresses poorly or the arena has no room; the
+ * caller then writes it to the swap disk. */
+bool
+zswap_store (struct anon_page *anon_page, const void *kva) {
+	if (page_is_zero (kva)) {
+		anon_page->zswap_chunk = ZSWAP_ZERO;
+		anon_page->zswap_len = 0;
+		return true;
+	}
+	if (arena == NULL) {
+		return false;
+	}
+
+	lock_acquire (&zswap_lock);
+	size_t len = lz_compress (kva, scratch, ZSWAP_MAX_LEN);
+	size_t chunk = BITMAP_ERROR;
+	if (len != 0) {
+		chunk = bitmap_scan_and_flip (arena_map, 0, DIV_ROUND_UP (len, ZSWAP_CHUNK), false);
+	}
+	if (chunk != BITMAP_ERROR) {
+		memcpy (arena + chunk * ZSWAP_CHUNK, scratch, len);
+	}
+	lock_release (&zswap_lock);
+
+	if (chunk == BITMAP_ERROR) {
+		return false;
+	}
+	anon_page->zswap_chunk = chunk;
+	anon_page->zswap_len = len;
+	return true;
+}
+
+/*** haein ***/
+/* Decompress ANON_PAGE's contents into KVA and release its space. */
+void
+zswap_load (struct anon_page *anon_page, void *kva) {
+	if (anon_page->zswap_chunk == ZSWAP_ZERO) {
+		memset (kva, 0, PGSIZE);
+	} else {
+		lock_acquire (&zswap_lock);
+		bool ok = lz_decompress (arena + anon_page->zswap_chunk * ZSWAP_CHUNK,
+				anon_page->zswap_len, kva);
+		lock_release (&zswap_lock);
+		if (!ok) {
+			PANIC ("zswap: corrupted entry at chunk %d", anon_page->zswap_chunk);
+		}
+	}
+	zswap_free (anon_page);
+}
+
+/*** haein ***/
+/* Release ANON_PAGE's space in the arena, if it has any. */
+void
+zswap_free (struct anon_page *anon_page) {
+	if (anon_page->zswap_chunk >= 0) {
+		lock_acquire (&zswap_lock);
+		bitmap_set_multiple (arena_map, anon_page->zswap_chunk,
+				DIV_ROUND_UP (anon_page->zswap_len, ZSWAP_CHUNK), false);
+		lock_release (&zswap_lock);
+	}
+	anon_page->zswap_chunk = ZSWAP_NONE;
+	anon_page->zswap_len = 0;
+}
+
+/*** haein ***/
+/* Returns true if the page at KVA is all zeros. */
+static bool
+page_is_zero (const void *kva) {
+	const uint64_t *word = kva;
+
+	for (size_t i = 0; i < PGSIZE / sizeof *word; i++) {
+		if (word[i] != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*** haein ***/
+/* Append the N literal bytes at SRC to DST + *OUT. Returns false if that
+ * would go past LIMIT. */
+static bool
+lz_emit_literals (const uint8_t *src, size_t n, uint8_t *dst, size_t *out, size_t limit) {
+	while (n > 0) {
+		size_t run = n < LZ_MAX_LITERAL ? n : LZ_MAX_LITERAL;
+		if (*out + 1 + run > limit) {
+			return false;
+		}
+		dst[(*out)++] = run - 1;
+		memcpy (dst + *out, src, run);
+		*out += run;
+		src += run;
+		n -= run;
+	}
+	return true;
+}
+
+/*** haein ***/
+/* Compress the page at SRC into DST. Matches are found through a hash of
+ * the next 4 bytes that remembers only the latest position, which is
+ * cheap and catches the zero runs and repeated records we care about.
+ * Returns the compressed length, or 0 if it would exceed LIMIT. Must
+ * hold zswap_lock (lz_table). */
+static size_t
+lz_compress (const uint8_t *src, uint8_t *dst, size_t limit) {
+	size_t i = 0, lit = 0, out = 0;
+
+	memset (lz_table, 0, sizeof lz_table);
+	while (i + LZ_MIN_MATCH <= PGSIZE) {
+		uint32_t seq;
+		memcpy (&seq, src + i, sizeof seq);
+		uint32_t h = (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+		size_t cand = lz_table[h];
+		lz_table[h] = i + 1;
+
+		if (cand == 0 || memcmp (src + cand - 1, src + i, LZ_MIN_MATCH)) {
+			i++;
+			continue;
+		}
+		cand--;
+
+		/* 겹치는 복사도 허용하므로 0이 이어지면 offset 1로 길게 잡힘 */
+		size_t len = LZ_MIN_MATCH;
+		while (i + len < PGSIZE && len < LZ_MAX_MATCH && src[cand + len] == src[i + len]) {
+			len++;
+		}
+
+		if (!lz_emit_literals (src + lit, i - lit, dst, &out, limit) || out + 3 > limit) {
+			return 0;
+		}
+		size_t off = i - cand;
+		dst[out++] = 0x80 | (len - LZ_MIN_MATCH);
+		dst[out++] = off & 0xff;
+		dst[out++] = off >> 8;
+
+		i += len;
+		lit = i;
+	}
+	if (!lz_emit_literals (src + lit, PGSIZE - lit, dst, &out, limit)) {
+		return 0;
+	}
+	return out;
+}
+
+/*** haein ***/
+/* Expand the LEN compressed bytes at SRC into the page at DST. Returns
+ * false if they do not describe exactly one page. */
+static bool
+lz_decompress (const uint8_t *src, size_t len, uint8_t *dst) {
+	size_t in = 0, out = 0;
+
+	while (in < len) {
+		uint8_t c = src[in++];
+
+		if (c < 0x80) {
+			size_t run = c + 1;
+			if (in + run > len || out + run > PGSIZE) {
+				return false;
+			}
+			memcpy (dst + out, src + in, run);
+			in += run;
+			out += run;
+		} else {
+			if (in + 2 > len) {
+				return false;
+			}
+			size_t mlen = (c & 0x7f) + LZ_MIN_MATCH;
+			size_t off = src[in] | (src[in + 1] << 8);
+			in += 2;
+			if (off == 0 || off > out || out + mlen > PGSIZE) {
+				return false;
+			}
+			for (size_t k = 0; k < mlen; k++, out++) {
+				dst[out] = dst[out - off];
+			}
+		}
+	}
+	return out == PGSIZE;
+}